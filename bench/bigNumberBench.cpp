@@ -0,0 +1,57 @@
+// BigNumber benchmark - limb-based engine vs. the original string-digit implementation
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "bigNumber.h"
+#include "legacyBigNumber.h"
+
+static std::string randomDigits(std::mt19937_64& rng, size_t count) {
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::string s;
+    s.reserve(count);
+    s.push_back(static_cast<char>('1' + digit(rng) % 9));
+    while (s.size() < count) s.push_back(static_cast<char>('0' + digit(rng)));
+    return s;
+}
+
+template <typename Number>
+static double timeAddSub(const std::string& a, const std::string& b, int iterations, std::string& out) {
+    Number x(a);
+    Number y(b);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        Number sum = x + y;
+        Number diff = sum - x;
+        x = diff + x;
+    }
+    auto end = std::chrono::steady_clock::now();
+    out = x.toString();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+static void runCase(const char* label, size_t digits, int iterations) {
+    std::mt19937_64 rng(digits);
+    std::string a = randomDigits(rng, digits);
+    std::string b = randomDigits(rng, digits);
+    // Put a decimal point in the middle of the second operand to exercise scale alignment
+    std::string bDecimal = b.substr(0, digits / 2) + "." + b.substr(digits / 2);
+
+    std::string limbResult, legacyResult;
+    double limbNs = timeAddSub<BigNumber>(a, b, iterations, limbResult);
+    double legacyNs = timeAddSub<LegacyBigNumber>(a, b, iterations, legacyResult);
+    std::printf("%-16s integer  limbs %12.1f ns/op  legacy %14.1f ns/op  speedup %7.1fx%s\n",
+        label, limbNs, legacyNs, legacyNs / limbNs, limbResult == legacyResult ? "" : "  MISMATCH");
+
+    limbNs = timeAddSub<BigNumber>(a, bDecimal, iterations, limbResult);
+    legacyNs = timeAddSub<LegacyBigNumber>(a, bDecimal, iterations, legacyResult);
+    std::printf("%-16s decimal  limbs %12.1f ns/op  legacy %14.1f ns/op  speedup %7.1fx\n",
+        label, limbNs, legacyNs, legacyNs / limbNs);
+}
+
+int main() {
+    runCase("50 digits", 50, 20000);
+    runCase("10k digits", 10000, 20);
+    return 0;
+}
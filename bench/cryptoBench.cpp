@@ -0,0 +1,98 @@
+// AES benchmark - AES-NI kernels vs. the constant-time software fallback
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aes.h"
+#include "encrypter.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double gigabytesPerSecond(size_t bytes, Clock::time_point start) {
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return bytes / seconds / 1e9;
+}
+
+static void runKernels(const char* label, bool forceSoftware, size_t bytes) {
+    uint8_t raw[32];
+    for (int i = 0; i < 32; i++) raw[i] = static_cast<uint8_t>(i * 7);
+    AesKey key;
+    aesExpandKey(raw, key, forceSoftware);
+
+    std::vector<uint8_t> plain(bytes), cipher(bytes), back(bytes);
+    for (size_t i = 0; i < bytes; i++) plain[i] = static_cast<uint8_t>(i);
+    size_t blocks = bytes / 16;
+
+    uint8_t iv[16] = { 0 };
+    auto start = Clock::now();
+    aesCbcEncrypt(key, iv, plain.data(), cipher.data(), blocks);
+    double encrypt = gigabytesPerSecond(bytes, start);
+
+    uint8_t iv2[16] = { 0 };
+    start = Clock::now();
+    aesCbcDecrypt(key, iv2, cipher.data(), back.data(), blocks);
+    double decrypt = gigabytesPerSecond(bytes, start);
+
+    start = Clock::now();
+    aesEncryptBlocks(key, plain.data(), cipher.data(), blocks);
+    double ecb = gigabytesPerSecond(bytes, start);
+
+    std::printf("%-9s  CBC encrypt %7.3f GB/s  CBC decrypt %7.3f GB/s  block encrypt %7.3f GB/s%s\n",
+        label, encrypt, decrypt, ecb, back == plain ? "" : "  MISMATCH");
+}
+
+int main() {
+    std::printf("AES-NI available: %s\n", aesHardwareAvailable() ? "yes" : "no");
+    if (aesHardwareAvailable()) {
+        runKernels("AES-NI", false, 256u << 20);
+    }
+    runKernels("software", true, 16u << 20);
+
+    // Full encrypter round trip including key setup and allocation
+    std::string payload(64u << 20, 'x');
+    std::string key = "benchmark-password**************";
+    auto start = Clock::now();
+    std::string encrypted = encryptAesCng(payload, key);
+    double encrypt = gigabytesPerSecond(payload.size(), start);
+    start = Clock::now();
+    std::string decrypted = decryptAesCng(encrypted, key);
+    double decrypt = gigabytesPerSecond(payload.size(), start);
+    std::printf("encryptAesCng %7.3f GB/s  decryptAesCng %7.3f GB/s%s\n",
+        encrypt, decrypt, decrypted == payload ? "" : "  MISMATCH");
+
+    // Chunked CTR container, one thread vs. every hardware thread
+    CryptoSession chunkSession(key);
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads : { 1u, cores }) {
+        start = Clock::now();
+        std::string container = encryptChunked(payload, chunkSession, threads);
+        double sealRate = gigabytesPerSecond(payload.size(), start);
+        std::string opened;
+        start = Clock::now();
+        bool ok = decryptChunked(container, chunkSession, opened, threads);
+        double openRate = gigabytesPerSecond(payload.size(), start);
+        std::printf("chunked CTR %2u thread(s)  encrypt %7.3f GB/s  decrypt %7.3f GB/s%s\n",
+            threads, sealRate, openRate, ok && opened == payload ? "" : "  MISMATCH");
+    }
+
+    // Small journal-sized records: per-call key setup vs. a session reused in place
+    const int records = 200000;
+    std::string record(64, 'r');
+    start = Clock::now();
+    for (int i = 0; i < records; i++) {
+        record = encryptAesCng(record, key);
+    }
+    double perCall = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / records;
+
+    CryptoSession session(key);
+    start = Clock::now();
+    for (int i = 0; i < records; i++) {
+        session.encryptInPlace(record);
+    }
+    double reused = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / records;
+    std::printf("64-byte record  encryptAesCng %7.1f ns  CryptoSession %7.1f ns\n", perCall, reused);
+    return 0;
+}
@@ -0,0 +1,284 @@
+#pragma once
+#include <string>
+#include <cctype>
+
+// Original string-digit BigNumber, kept only as the benchmark baseline
+class LegacyBigNumber {
+private:
+    std::string number;
+    bool negative;
+    
+    // Remove leading zeros
+    void normalize() {
+        size_t pos = number.find_first_not_of('0');
+        if (pos == std::string::npos) {
+            number = "0";
+            negative = false;
+        } else {
+            number = number.substr(pos);
+        }
+        if (number.empty()) {
+            number = "0";
+            negative = false;
+        }
+    }
+    
+    // Compare absolute values (returns: -1 if this < other, 0 if equal, 1 if this > other)
+    int compareAbs(const LegacyBigNumber& other) const {
+        if (number.length() < other.number.length()) return -1;
+        if (number.length() > other.number.length()) return 1;
+        return number.compare(other.number);
+    }
+    
+    std::string addPositive(const std::string& a, const std::string& b) const {
+        // Find decimal points
+        size_t decimalA = a.find('.');
+        size_t decimalB = b.find('.');
+        
+        // If no decimal points, use original logic
+        if (decimalA == std::string::npos && decimalB == std::string::npos) {
+            // Your original integer addition code here
+            std::string result;
+            int carry = 0;
+            int i = a.length() - 1;
+            int j = b.length() - 1;
+            
+            while (i >= 0 || j >= 0 || carry > 0) {
+                int sum = carry;
+                if (i >= 0) sum += (a[i--] - '0');
+                if (j >= 0) sum += (b[j--] - '0');
+                
+                result = char(sum % 10 + '0') + result;
+                carry = sum / 10;
+            }
+            return result;
+        }
+        
+        // Handle decimal numbers
+        std::string intA = (decimalA == std::string::npos) ? a : a.substr(0, decimalA);
+        std::string fracA = (decimalA == std::string::npos) ? "" : a.substr(decimalA + 1);
+        std::string intB = (decimalB == std::string::npos) ? b : b.substr(0, decimalB);
+        std::string fracB = (decimalB == std::string::npos) ? "" : b.substr(decimalB + 1);
+        
+        // Pad fractional parts to same length
+        while (fracA.length() < fracB.length()) fracA += "0";
+        while (fracB.length() < fracA.length()) fracB += "0";
+        
+        // Add fractional parts first
+        std::string fracResult;
+        int carry = 0;
+        for (int i = fracA.length() - 1; i >= 0; i--) {
+            int sum = carry + (fracA[i] - '0') + (fracB[i] - '0');
+            fracResult = char(sum % 10 + '0') + fracResult;
+            carry = sum / 10;
+        }
+        
+        // Add integer parts
+        std::string intResult;
+        int i = intA.length() - 1;
+        int j = intB.length() - 1;
+        
+        while (i >= 0 || j >= 0 || carry > 0) {
+            int sum = carry;
+            if (i >= 0) sum += (intA[i--] - '0');
+            if (j >= 0) sum += (intB[j--] - '0');
+            
+            intResult = char(sum % 10 + '0') + intResult;
+            carry = sum / 10;
+        }
+        
+        // Combine results
+        if (fracResult.empty()) return intResult;
+        return intResult + "." + fracResult;
+    }
+    
+    // Subtract two positive numbers (assumes a >= b)
+    std::string subtractPositive(const std::string& a, const std::string& b) const {
+        // Find decimal points
+        size_t decimalA = a.find('.');
+        size_t decimalB = b.find('.');
+        
+        // If no decimal points, use original logic
+        if (decimalA == std::string::npos && decimalB == std::string::npos) {
+            // Your original integer subtraction code here
+            std::string result;
+            int borrow = 0;
+            int i = a.length() - 1;
+            int j = b.length() - 1;
+            
+            while (i >= 0) {
+                int sub = (a[i] - '0') - borrow;
+                if (j >= 0) sub -= (b[j--] - '0');
+                
+                if (sub < 0) {
+                    sub += 10;
+                    borrow = 1;
+                } else {
+                    borrow = 0;
+                }
+                
+                result = char(sub + '0') + result;
+                i--;
+            }
+            return result;
+        }
+        
+        // Handle decimal numbers
+        std::string intA = (decimalA == std::string::npos) ? a : a.substr(0, decimalA);
+        std::string fracA = (decimalA == std::string::npos) ? "" : a.substr(decimalA + 1);
+        std::string intB = (decimalB == std::string::npos) ? b : b.substr(0, decimalB);
+        std::string fracB = (decimalB == std::string::npos) ? "" : b.substr(decimalB + 1);
+        
+        // Pad fractional parts to same length
+        while (fracA.length() < fracB.length()) fracA += "0";
+        while (fracB.length() < fracA.length()) fracB += "0";
+        
+        // Subtract fractional parts first
+        std::string fracResult;
+        int borrow = 0;
+        for (int i = fracA.length() - 1; i >= 0; i--) {
+            int sub = (fracA[i] - '0') - borrow - (fracB[i] - '0');
+            
+            if (sub < 0) {
+                sub += 10;
+                borrow = 1;
+            } else {
+                borrow = 0;
+            }
+            
+            fracResult = char(sub + '0') + fracResult;
+        }
+        
+        // Subtract integer parts
+        std::string intResult;
+        int i = intA.length() - 1;
+        int j = intB.length() - 1;
+        
+        while (i >= 0) {
+            int sub = (intA[i] - '0') - borrow;
+            if (j >= 0) sub -= (intB[j--] - '0');
+            
+            if (sub < 0) {
+                sub += 10;
+                borrow = 1;
+            } else {
+                borrow = 0;
+            }
+            
+            intResult = char(sub + '0') + intResult;
+            i--;
+        }
+        
+        // Remove trailing zeros from fractional part
+        while (!fracResult.empty() && fracResult.back() == '0') {
+            fracResult.pop_back();
+        }
+        
+        // Combine results
+        if (fracResult.empty()) return intResult;
+        return intResult + "." + fracResult;
+    }
+    
+public:
+    LegacyBigNumber() : number("0"), negative(false) {}
+    
+    LegacyBigNumber(const std::string& str) {
+        if (str.empty() || str == "0") {
+            number = "0";
+            negative = false;
+            return;
+        }
+        
+        negative = (str[0] == '-');
+        number = negative ? str.substr(1) : str;
+        
+        // Validate that it's all digits (allow decimal point)
+        bool hasDecimal = false;
+        std::string cleanNumber;
+        for (char c : number) {
+            if (c == '.') {
+                if (hasDecimal) {
+                    number = "0";
+                    negative = false;
+                    return;
+                }
+                hasDecimal = true;
+                cleanNumber += c;  // Add this line to preserve the decimal point
+            } else if (std::isdigit(c)) {
+                cleanNumber += c;
+            } else {
+                number = "0";
+                negative = false;
+                return;
+            }
+        }
+
+        number = cleanNumber.empty() ? "0" : cleanNumber;
+        normalize();
+    }
+    
+    LegacyBigNumber(long long val) {
+        if (val < 0) {
+            negative = true;
+            val = -val;
+        } else {
+            negative = false;
+        }
+        number = std::to_string(val);
+    }
+    
+    std::string toString() const {
+        if (number == "0") return "0";
+        return (negative ? "-" : "") + number;
+    }
+    
+    bool isZero() const {
+        return number == "0";
+    }
+    
+    bool isNegative() const {
+        return negative && !isZero();
+    }
+    
+    LegacyBigNumber operator+(const LegacyBigNumber& other) const {
+        LegacyBigNumber result;
+        
+        if (negative == other.negative) {
+            // Same signs: add absolute values
+            result.number = addPositive(number, other.number);
+            result.negative = negative;
+        } else {
+            // Different signs: subtract absolute values
+            int cmp = compareAbs(other);
+            if (cmp == 0) {
+                result.number = "0";
+                result.negative = false;
+            } else if (cmp > 0) {
+                result.number = subtractPositive(number, other.number);
+                result.negative = negative;
+            } else {
+                result.number = subtractPositive(other.number, number);
+                result.negative = other.negative;
+            }
+        }
+        
+        result.normalize();
+        return result;
+    }
+    
+    LegacyBigNumber operator-(const LegacyBigNumber& other) const {
+        LegacyBigNumber temp = other;
+        temp.negative = !temp.negative;
+        return *this + temp;
+    }
+    
+    LegacyBigNumber& operator+=(const LegacyBigNumber& other) {
+        *this = *this + other;
+        return *this;
+    }
+    
+    LegacyBigNumber& operator-=(const LegacyBigNumber& other) {
+        *this = *this - other;
+        return *this;
+    }
+};
@@ -0,0 +1,390 @@
+// MoneyTracker benchmark suite - headless micro and macro benchmarks on moneytracker_core.
+// Prints one JSON object per line so results can be collected and compared across runs:
+//   {"benchmark":"...","records":N,"bytes":B,"iterations":I,"ns_per_op":X,"mb_per_s":Y}
+// Usage: MoneyTrackerBench [--max-records N] [--filter substring]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "account.h"
+#include "balanceHistory.h"
+#include "bigNumber.h"
+#include "blockContainer.h"
+#include "crc32c.h"
+#include "ledgerIndex.h"
+#include "encrypter.h"
+#include "mappedFile.h"
+#include "nameIndex.h"
+#include "savingFunctions.h"
+
+using Clock = std::chrono::steady_clock;
+
+static const char* filter = nullptr;
+
+static bool selected(const char* name) {
+    return filter == nullptr || std::strstr(name, filter) != nullptr;
+}
+
+// True when any benchmark in a group is selected (skips expensive setup otherwise)
+static bool anySelected(std::initializer_list<const char*> names) {
+    for (const char* name : names) {
+        if (selected(name)) return true;
+    }
+    return false;
+}
+
+// Keeps a result alive so the optimizer cannot drop the work that produced it
+template <typename T>
+static void sink(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static const void* volatile escape;
+    escape = &value;
+#endif
+}
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// bytes = 0 prints mb_per_s as null
+static void report(const char* name, size_t records, size_t iterations, double seconds, size_t bytes) {
+    std::printf("{\"benchmark\":\"%s\",\"records\":%zu,\"bytes\":%zu,\"iterations\":%zu,\"ns_per_op\":%.1f,\"mb_per_s\":",
+        name, records, bytes, iterations, seconds * 1e9 / iterations);
+    if (bytes > 0) {
+        std::printf("%.1f}\n", bytes * static_cast<double>(iterations) / seconds / 1e6);
+    } else {
+        std::printf("null}\n");
+    }
+    std::fflush(stdout);
+}
+
+// Run op after one warm-up call until at least 0.2 s has passed, then report the mean
+template <typename Op>
+static void measure(const char* name, size_t records, size_t bytes, Op op) {
+    if (!selected(name)) return;
+    op();
+    size_t iterations = 0;
+    auto start = Clock::now();
+    double seconds = 0;
+    do {
+        op();
+        iterations++;
+        seconds = secondsSince(start);
+    } while (seconds < 0.2);
+    report(name, records, iterations, seconds, bytes);
+}
+
+// ------------------------------
+// Micro benchmarks
+// ------------------------------
+static void benchBigNumber() {
+    const size_t iterations = 1000000;
+    BigNumber a("12345678901234567890123456789012345678901234567890.25");
+    BigNumber b("98765432109876543210987654321098765432109876543210.5");
+
+    if (selected("bigNumber.add")) {
+        BigNumber sum = a;
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; i++) sum += b;
+        report("bigNumber.add", 1, iterations, secondsSince(start), 0);
+        sink(sum);
+    }
+    if (selected("bigNumber.sub")) {
+        BigNumber diff = a;
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; i++) diff -= b;
+        report("bigNumber.sub", 1, iterations, secondsSince(start), 0);
+        sink(diff);
+    }
+}
+
+static void fillBorrowers(size_t records, std::map<std::string, std::string>& dataMap, CounterpartyTable& counterparties) {
+    dataMap = {{"Total Money", "123456.78"}, {"Last Transaction", "-12.5"}, {"Short Note", "groceries"}};
+    counterparties.clear();
+    for (size_t i = 0; i < records; i++) {
+        std::string name = "Person " + std::to_string(i);
+        counterparties.setBalance(counterparties.findOrAdd(name), Amount((i % 2 ? "-" : "") + std::to_string(i * 37 % 100000) + ".25"));
+    }
+}
+
+static void benchTextFormat(size_t records) {
+    if (!anySelected({ "save.dataToString", "save.stringToData" })) return;
+
+    std::map<std::string, std::string> dataMap;
+    CounterpartyTable counterparties;
+    fillBorrowers(records, dataMap, counterparties);
+
+    std::string text = dataToString(dataMap, counterparties);
+    measure("save.dataToString", records, text.size(), [&]() {
+        text = dataToString(dataMap, counterparties);
+    });
+    measure("save.stringToData", records, text.size(), [&]() {
+        std::map<std::string, std::string> outData;
+        CounterpartyTable outCounterparties;
+        stringToData(text, outData, outCounterparties);
+    });
+}
+
+// Index build after login, then one keystroke: a short prefix matching ~1/10 of the names
+static void benchSearch(size_t records) {
+    if (!anySelected({ "search.build", "search.prefix" })) return;
+
+    std::map<std::string, std::string> dataMap;
+    CounterpartyTable counterparties;
+    fillBorrowers(records, dataMap, counterparties);
+
+    NameIndex index;
+    if (selected("search.build")) {
+        auto start = Clock::now();
+        index.sync(counterparties);
+        report("search.build", records, 1, secondsSince(start), 0);
+    }
+    index.sync(counterparties);
+
+    size_t found = 0;
+    measure("search.prefix", records, 0, [&]() {
+        found += index.search("PERSON 7").count;
+    });
+    sink(found);
+}
+
+// Re-sorting the borrower table by balance, starting from name order as the GUI does
+static void benchSort(size_t records) {
+    if (!selected("sort.byBalance")) return;
+
+    std::map<std::string, std::string> dataMap;
+    CounterpartyTable counterparties;
+    fillBorrowers(records, dataMap, counterparties);
+    NameIndex index;
+    index.sync(counterparties);
+    NameIndex::Matches all = index.search("");
+
+    std::vector<uint32_t> order;
+    measure("sort.byBalance", records, 0, [&]() {
+        order.assign(all.ids, all.ids + all.count);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return counterparties.compareBalances(a, b) < 0;
+        });
+    });
+}
+
+// Balance chart: pyramid build after login, then one frame of a full-history
+// chart and of a zoomed-in window, each 800 pixel columns wide
+static void benchHistory(size_t records) {
+    if (!anySelected({ "history.build", "history.sampleAll", "history.sampleZoomed" })) return;
+
+    Ledger ledger;
+    ledger.reset(Amount("1000"));
+    for (size_t i = 0; i < records; i++) {
+        Amount amount = Amount::fromUnits(i % 2 ? -static_cast<int64_t>(i % 9973) : static_cast<int64_t>(i % 7919));
+        ledger.append(amount, Ledger::NO_COUNTERPARTY, {}, 1700000000 + static_cast<int64_t>(i));
+    }
+
+    BalanceHistory history;
+    if (selected("history.build")) {
+        auto start = Clock::now();
+        history.sync(ledger);
+        report("history.build", records, 1, secondsSince(start), 0);
+    }
+    history.sync(ledger);
+
+    std::vector<BalanceRange> columns;
+    measure("history.sampleAll", records, 0, [&]() {
+        history.sample(ledger, 0, records, 800, columns);
+    });
+    measure("history.sampleZoomed", records, 0, [&]() {
+        history.sample(ledger, records / 2, records / 2 + std::min<size_t>(records / 2, 4000), 800, columns);
+    });
+}
+
+// Date queries: index build after login, then one balance lookup for the
+// account and one for a counterparty (every tenth entry belongs to one of 100)
+static void benchIndex(size_t records) {
+    if (!anySelected({ "index.build", "index.balanceAt", "index.counterpartyBalanceAt" })) return;
+
+    Ledger ledger;
+    ledger.reset(Amount("1000"));
+    for (size_t i = 0; i < records; i++) {
+        Amount amount = Amount::fromUnits(i % 2 ? -static_cast<int64_t>(i % 9973) : static_cast<int64_t>(i % 7919));
+        uint32_t counterparty = i % 10 == 0 ? static_cast<uint32_t>(i / 10 % 100) : Ledger::NO_COUNTERPARTY;
+        ledger.append(amount, counterparty, {}, 1700000000 + static_cast<int64_t>(i));
+    }
+
+    LedgerIndex index;
+    if (selected("index.build")) {
+        auto start = Clock::now();
+        index.sync(ledger);
+        report("index.build", records, 1, secondsSince(start), 0);
+    }
+    index.sync(ledger);
+
+    size_t query = 0;
+    Amount sum;
+    measure("index.balanceAt", records, 0, [&]() {
+        sum += index.balanceAt(ledger, 1700000000 + static_cast<int64_t>(query++ * 7919 % records));
+    });
+    Amount current("5");
+    measure("index.counterpartyBalanceAt", records, 0, [&]() {
+        size_t q = query++;
+        sum += index.counterpartyBalanceAt(static_cast<uint32_t>(q % 100), 1700000000 + static_cast<int64_t>(q * 7919 % records), current);
+    });
+    sink(sum);
+}
+
+static void benchCrypto(size_t bytes) {
+    std::string payload(bytes, 'x');
+    std::string key(32, 'k');
+    CryptoSession session(key);
+
+    measure("crypto.cbcRoundTrip", 0, bytes, [&]() {
+        std::string decrypted = decryptAesCng(encryptAesCng(payload, key), key);
+    });
+    measure("crypto.chunkedRoundTrip", 0, bytes, [&]() {
+        std::string decrypted;
+        decryptChunked(encryptChunked(payload, session), session, decrypted);
+    });
+
+    uint32_t checksum = 0;
+    measure("crc32c.auto", 0, bytes, [&]() {
+        checksum ^= crc32c(payload.data(), payload.size());
+    });
+    measure("crc32c.software", 0, bytes, [&]() {
+        checksum ^= crc32c(payload.data(), payload.size(), 0, true);
+    });
+    sink(checksum);
+}
+
+// ------------------------------
+// Macro benchmark: create -> snapshot save -> login -> journal save
+// Records are ledger transactions; one borrower per 100 records.
+// ------------------------------
+static void benchPipeline(size_t records, const std::filesystem::path& dir) {
+    if (!anySelected({ "pipeline.snapshotSave", "pipeline.login", "pipeline.openSummary", "pipeline.loadLedger", "pipeline.rejectPassword", "pipeline.journalSave" })) return;
+
+    std::string dataFile = (dir / "bench.data").string();
+    std::string journalFile = (dir / "bench.journal").string();
+    std::error_code ec;
+    std::filesystem::remove(dataFile, ec);
+    std::filesystem::remove(journalFile, ec);
+
+    // 2024-01-01: 10^7 one-second steps stay inside the year, so login never
+    // finds a closed year and starts a compaction that would race the timings
+    const int64_t firstTime = 1704067200;
+    size_t snapshotBytes = 0;
+    {
+        Account account(dataFile, journalFile);
+        createAccount(account, "benchmark", "1000");
+        for (size_t i = 0; i < records / 100; i++) {
+            applyMutation(account, Mutation{ MutationType::BORROWER, firstTime, "Person " + std::to_string(i), "25.50" });
+        }
+        for (size_t i = account.ledger.size(); i < records; i++) {
+            Amount amount = Amount::fromUnits(i % 2 ? -static_cast<int64_t>(i % 9973) : static_cast<int64_t>(i % 7919));
+            account.ledger.append(amount, Ledger::NO_COUNTERPARTY, {}, firstTime + static_cast<int64_t>(i));
+        }
+        account.dataMap["Total Money"] = account.ledger.getBalance().toString();
+
+        auto start = Clock::now();
+        bool ok = saveData(account);
+        double seconds = secondsSince(start);
+        snapshotBytes = static_cast<size_t>(std::filesystem::file_size(dataFile, ec));
+        if (ok && selected("pipeline.snapshotSave")) report("pipeline.snapshotSave", records, 1, seconds, snapshotBytes);
+    }
+
+    if (selected("pipeline.openSummary")) {
+        // Dashboard-only open: header, index and summary block
+        CryptoSession crypto(std::string("benchmark") + std::string(23, '*'));
+        auto start = Clock::now();
+        MappedFile file;
+        BlockReader reader;
+        SaveSummary summary;
+        bool ok = file.open(dataFile) && reader.open(file.view(), crypto) && readSaveSummary(reader, summary);
+        double seconds = secondsSince(start);
+        if (ok) report("pipeline.openSummary", records, 1, seconds, snapshotBytes);
+    }
+
+    {
+        Account account(dataFile, journalFile);
+        account.fileExists = true;
+        auto start = Clock::now();
+        LoginResult result = loginAccount(account, "benchmark");
+        double seconds = secondsSince(start);
+        if (result == LoginResult::SUCCESS && selected("pipeline.login")) {
+            report("pipeline.login", records, 1, seconds, snapshotBytes);
+        }
+
+        // Ledger entries login left on disk, read when the chart or history needs them
+        start = Clock::now();
+        startLedgerLoad(account);
+        account.waitForWorker();
+        finishSave(account);
+        seconds = secondsSince(start);
+        if (result == LoginResult::SUCCESS && !account.ledgerDeferred && selected("pipeline.loadLedger")) {
+            report("pipeline.loadLedger", records, 1, seconds, snapshotBytes);
+        }
+
+        start = Clock::now();
+        result = loginAccount(account, "wrong password");
+        seconds = secondsSince(start);
+        if (result == LoginResult::WRONG_PASSWORD && selected("pipeline.rejectPassword")) {
+            report("pipeline.rejectPassword", records, 1, seconds, 0);
+        }
+
+        loginAccount(account, "benchmark");
+        const size_t changes = 100;
+        for (size_t i = 0; i < changes; i++) {
+            recordMutation(account, MutationType::TRANSACTION, "", "1.25");
+        }
+        start = Clock::now();
+        bool ok = saveData(account);
+        seconds = secondsSince(start);
+        if (ok && selected("pipeline.journalSave")) report("pipeline.journalSave", records, changes, seconds, 0);
+    }
+
+    std::filesystem::remove(dataFile, ec);
+    std::filesystem::remove(journalFile, ec);
+}
+
+int main(int argc, char** argv) {
+    size_t maxRecords = 10000000;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--max-records") == 0 && i + 1 < argc) {
+            maxRecords = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            std::fprintf(stderr, "Usage: %s [--max-records N] [--filter substring]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "moneytracker-bench";
+    std::filesystem::create_directories(dir);
+
+    benchBigNumber();
+    for (size_t records = 100; records <= maxRecords; records *= 10) {
+        benchTextFormat(records);
+        benchSearch(records);
+        benchSort(records);
+        benchHistory(records);
+        benchIndex(records);
+    }
+    for (size_t bytes = 1024; bytes <= (64u << 20); bytes *= 16) {
+        benchCrypto(bytes);
+    }
+    for (size_t records = 100; records <= maxRecords; records *= 10) {
+        benchPipeline(records, dir);
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Save format benchmark - binary sections vs. the ':' ',' '|' text encoding
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "counterparties.h"
+#include "ledger.h"
+#include "savingFunctions.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double millisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static bool sameCounterparties(const CounterpartyTable& a, const CounterpartyTable& b) {
+    if (a.size() != b.size()) return false;
+    for (uint32_t id = 0; id < a.size(); id++) {
+        if (a.nameOf(id) != b.nameOf(id) || a.balanceOf(id).compare(b.balanceOf(id)) != 0) return false;
+    }
+    return true;
+}
+
+static void runCase(size_t records) {
+    std::map<std::string, std::string> dataMap = {
+        {"Total Money", "123456.78"},
+        {"Last Transaction", "-12.5"},
+        {"Short Note", "groceries"}
+    };
+    CounterpartyTable counterparties;
+    for (size_t i = 0; i < records; i++) {
+        std::string name = "Person " + std::to_string(i);
+        counterparties.setBalance(counterparties.findOrAdd(name), Amount((i % 2 ? "-" : "") + std::to_string(i * 37 % 100000) + ".25"));
+    }
+    Ledger ledger;
+    ledger.reset(Amount(dataMap["Total Money"]));
+
+    auto start = Clock::now();
+    std::string text = dataToString(dataMap, counterparties);
+    double textSave = millisSince(start);
+
+    start = Clock::now();
+    std::string binary = dataToBinary(dataMap, counterparties, ledger);
+    double binarySave = millisSince(start);
+
+    std::map<std::string, std::string> outData;
+    CounterpartyTable outCounterparties;
+    start = Clock::now();
+    stringToData(text, outData, outCounterparties);
+    double textLoad = millisSince(start);
+    bool textOk = sameCounterparties(outCounterparties, counterparties);
+
+    outData.clear();
+    Ledger outLedger;
+    start = Clock::now();
+    bool binaryOk = binaryToData(binary, outData, outCounterparties, outLedger);
+    double binaryLoad = millisSince(start);
+    binaryOk = binaryOk && sameCounterparties(outCounterparties, counterparties) && outData == dataMap;
+
+    double textMB = text.size() / 1e6;
+    double binaryMB = binary.size() / 1e6;
+    std::printf("%8zu records  save: text %8.2f ms (%7.1f MB/s)  binary %8.2f ms (%7.1f MB/s)\n",
+        records, textSave, textMB / (textSave / 1e3), binarySave, binaryMB / (binarySave / 1e3));
+    std::printf("%8s          load: text %8.2f ms (%7.1f MB/s)  binary %8.2f ms (%7.1f MB/s)%s\n",
+        "", textLoad, textMB / (textLoad / 1e3), binaryLoad, binaryMB / (binaryLoad / 1e3),
+        (textOk && binaryOk) ? "" : "  MISMATCH");
+}
+
+int main() {
+    for (size_t records = 1000; records <= 1000000; records *= 10) {
+        runCase(records);
+    }
+    return 0;
+}
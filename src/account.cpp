@@ -0,0 +1,487 @@
+#include "account.h"
+#include <algorithm>
+#include <climits>
+#include <filesystem>
+#include <iterator>
+
+#include "blockContainer.h"
+#include "mappedFile.h"
+#include "savingFunctions.h"
+
+namespace {
+    // Passwords are padded with '*' to the 32-byte AES-256 key size
+    void setUserKey(Account& account, const std::string& password) {
+        account.userKey = password;
+        if (account.userKey.length() <= 32) {
+            account.userKey.append(32 - account.userKey.length(), '*');
+        }
+        account.crypto.setKey(account.userKey);
+    }
+
+    // Drop a half-loaded save so a later attempt starts clean
+    LoginResult abandonLogin(Account& account, LoginResult result) {
+        account.crypto.clear();
+        account.dataMap.clear();
+        account.counterparties.clear();
+        account.ledger.reset(Amount());
+        account.segments.clear();
+        account.ledgerDeferred = false;
+        account.deferredLedger = LedgerSegment();
+        return result;
+    }
+
+    // Last activity is not stored in the snapshot; recover it from the ledger
+    void touchCounterparties(Account& account) {
+        for (const LedgerEntry& entry : account.ledger.getEntries()) {
+            if (entry.counterparty < account.counterparties.size()) {
+                account.counterparties.touch(entry.counterparty, entry.timestamp);
+            }
+        }
+    }
+
+    // Snapshot job body: close finished years first, then write what is left of
+    // the ledger. update is only meaningful when this returns true.
+    bool writeArchivedSnapshot(const std::string& path, const CryptoSession& crypto, const std::map<std::string, std::string>& dataMap,
+                               const CounterpartyTable& counterparties, const Ledger& ledger,
+                               const std::vector<LedgerSegment>& segments, uint64_t sequence, ArchiveUpdate& update) {
+        if (!archiveClosedYears(path, crypto, counterparties, ledger, segments, update)) {
+            update = ArchiveUpdate{ segments.size(), 0, segments }; // Keep every entry in the snapshot instead
+        }
+        std::string encrypted;
+        if (update.archivedEntries > 0) {
+            Ledger openYear = ledger.slice(update.archivedEntries, ledger.size(), update.segments.back().closingBalance);
+            encrypted = dataToBlocks(dataMap, counterparties, openYear, update.segments, sequence, crypto);
+        } else {
+            encrypted = dataToBlocks(dataMap, counterparties, ledger, update.segments, sequence, crypto);
+        }
+        if (!writeSnapshot(encrypted, path)) {
+            update = ArchiveUpdate();
+            return false;
+        }
+        return true;
+    }
+
+    // Decrypt and parse the data file into account (crypto must be set); the
+    // journal is left alone. Shared by login, which may leave the ledger of a
+    // block save on disk, and the compaction job, which rebuilds the saved
+    // state from disk instead of copying the live account.
+    LoginResult readSnapshot(Account& account, uint64_t& journalSequence, LoadProgress* progress, bool deferLedger) {
+        account.ledgerDeferred = false;
+        account.ledgerLoadFailed = false;
+        account.deferredLedger = LedgerSegment();
+        // The file is mapped rather than read. Block saves decrypt block by block
+        // into their final structures; older saves decrypt into one plaintext
+        // buffer, unmapped again before parsing, that the parser reads through views.
+        std::string decrypted;
+        bool blockSave = false;
+        {
+            MappedFile file;
+            if (!file.open(account.dataFile)) {
+                account.crypto.clear();
+                return LoginResult::READ_ERROR;
+            }
+            std::string_view saves = file.view();
+            if (!passwordMatches(saves, account.crypto)) {
+                account.crypto.clear();
+                return LoginResult::WRONG_PASSWORD;
+            }
+            if (progress) progress->bytesTotal = saves.size();
+
+            blockSave = isBlockContainer(saves);
+            if (blockSave) {
+                BlockReader reader;
+                bool loaded = reader.open(saves, account.crypto) &&
+                    blocksToData(reader, account.dataMap, account.counterparties, account.ledger, &account.segments, &journalSequence,
+                                 progress, deferLedger ? &account.deferredLedger : nullptr);
+                account.ledgerDeferred = account.deferredLedger.entryCount > 0;
+                if (progress && progress->cancelled) return abandonLogin(account, LoginResult::CANCELLED);
+                if (!loaded) return abandonLogin(account, LoginResult::CORRUPTED);
+                if (progress) progress->bytesDecrypted = progress->bytesTotal.load(); // Header and index included
+            } else if (isChunkedContainer(saves)) {
+                if (!decryptChunked(saves, account.crypto, decrypted, 0,
+                                    progress ? &progress->bytesDecrypted : nullptr,
+                                    progress ? &progress->cancelled : nullptr)) {
+                    decrypted.clear();
+                }
+            } else {
+                // Legacy single-stream CBC save
+                decrypted.resize(saves.size());
+                if (!account.crypto.decrypt(saves.data(), &decrypted[0], saves.size())) decrypted.clear();
+            }
+            if (progress && !decrypted.empty()) progress->bytesDecrypted = progress->bytesTotal.load(); // Header bytes included
+        }
+
+        if (!blockSave) {
+            std::string suffix = "valid";
+            if (progress && progress->cancelled) return abandonLogin(account, LoginResult::CANCELLED);
+
+            if (decrypted.size() < suffix.size() ||
+                decrypted.compare(decrypted.size() - suffix.size(), suffix.size(), suffix) != 0) {
+                return abandonLogin(account, LoginResult::CORRUPTED);
+            }
+            decrypted.erase(decrypted.size() - suffix.size());
+
+            account.segments.clear(); // Older formats keep the whole ledger in the snapshot
+            if (!loadSaveData(decrypted, account.dataMap, account.counterparties, account.ledger, &journalSequence, progress)) {
+                return abandonLogin(account, progress && progress->cancelled ? LoginResult::CANCELLED : LoginResult::CORRUPTED);
+            }
+        }
+        touchCounterparties(account);
+        return LoginResult::SUCCESS;
+    }
+
+    // Put the entries a job read back from the snapshot in front of the live
+    // ones, unless they do not end where the live ledger starts
+    void applyLoadedLedger(Account& account) {
+        if (!account.ledgerLoaded) return;
+        Ledger base = std::move(account.loadedLedger);
+        account.loadedLedger = Ledger();
+        account.ledgerLoaded = false;
+        if (!account.ledgerDeferred) return;
+        if (base.size() != account.deferredLedger.entryCount ||
+            base.getBalance().compare(account.ledger.getOpeningBalance()) != 0) {
+            account.ledgerLoadFailed = true;
+            return;
+        }
+        account.ledger.prepend(std::move(base));
+        account.ledgerDeferred = false;
+        account.deferredLedger = LedgerSegment();
+    }
+
+    // Trim the live ledger to match a snapshot that closed years. Entries
+    // appended after the state the job wrote come after the cut and stay.
+    void applyArchive(Account& account) {
+        ArchiveUpdate update = std::move(account.archiveUpdate);
+        account.archiveUpdate = ArchiveUpdate();
+        if (update.archivedEntries == 0 || update.baseSegments != account.segments.size() ||
+            update.archivedEntries > account.ledger.size()) return;
+        account.ledger = account.ledger.slice(update.archivedEntries, account.ledger.size(), update.segments.back().closingBalance);
+        account.segments = std::move(update.segments);
+    }
+}
+
+void createAccount(Account& account, const std::string& password, const std::string& initialMoney) {
+    setUserKey(account, password);
+
+    account.dataMap = {
+        {"Total Money", initialMoney},
+        {"Last Transaction", "-"},
+        {"Short Note", "-"}
+    };
+    account.counterparties.clear();
+    account.ledger.reset(Amount(initialMoney));
+    account.segments.clear();
+    account.ledgerDeferred = false;
+    account.deferredLedger = LedgerSegment();
+}
+
+LoginResult loginAccount(Account& account, const std::string& password, LoadProgress* progress) {
+    setUserKey(account, password);
+    uint64_t journalSequence = 0;
+    LoginResult result = readSnapshot(account, journalSequence, progress, true);
+    if (result != LoginResult::SUCCESS) return result;
+
+    // Replay changes saved since the snapshot was written
+    // Appending behind a damaged frame would hide the new changes too, so stop here
+    std::vector<Mutation> changes;
+    if (!account.journal.read(account.crypto, journalSequence, changes)) {
+        return abandonLogin(account, LoginResult::JOURNAL_CORRUPTED);
+    }
+    for (const Mutation& mutation : changes) {
+        applyMutation(account, mutation);
+    }
+    if (progress) {
+        progress->recordsParsed += changes.size();
+        if (progress->cancelled) return abandonLogin(account, LoginResult::CANCELLED);
+    }
+    // Compact early when the journal is long or the open ledger has run into a
+    // new year (the block index gives the time range of deferred entries)
+    const std::vector<LedgerEntry>& entries = account.ledger.getEntries();
+    bool yearClosed = !entries.empty() && Ledger::yearOf(entries.front().timestamp) < Ledger::yearOf(entries.back().timestamp);
+    if (account.ledgerDeferred) {
+        int64_t latest = account.deferredLedger.maxTime;
+        if (!entries.empty()) latest = std::max(latest, entries.back().timestamp);
+        yearClosed = Ledger::yearOf(account.deferredLedger.minTime) < Ledger::yearOf(latest);
+    }
+    if (account.journal.getSizeBytes() > JOURNAL_COMPACT_BYTES || yearClosed) {
+        startCompaction(account);
+    }
+    return LoginResult::SUCCESS;
+}
+
+void applyMutation(Account& account, const Mutation& mutation) {
+    switch (mutation.type) {
+        case MutationType::TRANSACTION: {
+            Amount amount(mutation.value);
+            account.ledger.append(amount, Ledger::NO_COUNTERPARTY, {}, mutation.timestamp);
+            account.dataMap["Last Transaction"] = amount.toString();
+            account.dataMap["Total Money"] = account.ledger.getBalance().toString();
+            break;
+        }
+        case MutationType::BORROWER: {
+            Amount amount(mutation.value);
+            uint32_t counterparty = account.counterparties.findOrAdd(mutation.name);
+            account.counterparties.addToBalance(counterparty, amount);
+            account.counterparties.touch(counterparty, mutation.timestamp);
+            account.ledger.append(amount, counterparty, {}, mutation.timestamp);
+            account.dataMap["Total Money"] = account.ledger.getBalance().toString();
+            break;
+        }
+        case MutationType::NOTE:
+            account.dataMap["Short Note"] = mutation.value.empty() ? "-" : mutation.value;
+            break;
+    }
+}
+
+void recordMutation(Account& account, MutationType type, const std::string& name, const std::string& value) {
+    Mutation mutation{ type, Ledger::currentTimestamp(), name, value };
+    applyMutation(account, mutation);
+    account.pendingMutations.push_back(std::move(mutation));
+}
+
+bool saveData(Account& account) {
+    account.waitForWorker();
+    finishSave(account);
+
+    if (!account.fileExists) {
+        if (!writeArchivedSnapshot(account.dataFile, account.crypto, account.dataMap, account.counterparties,
+                                   account.ledger, account.segments, 0, account.archiveUpdate)) return false;
+        applyArchive(account);
+        account.journal.remove();
+        account.fileExists = true;
+    } else if (!account.journal.append(account.pendingMutations, account.crypto)) {
+        return false;
+    }
+    account.pendingMutations.clear();
+    return true;
+}
+
+void startCompaction(Account& account) {
+    account.waitForWorker();
+    finishSave(account);
+
+    // The job reads the saved state back from disk instead of copying the live
+    // account here, so starting it costs the UI thread nothing however large
+    // the data is. Unsaved edits are not part of it either; they reach the
+    // journal after the sequence the new snapshot covers. A live ledger that
+    // still has entries on disk gets them from the job, read before the
+    // snapshot is replaced.
+    uint64_t sequence = account.journal.getLastSequence();
+    account.workerRunning = true;
+    account.workerThread = std::thread(
+        [&running = account.workerRunning, &journal = account.journal, &update = account.archiveUpdate,
+         &loaded = account.loadedLedger, &ledgerLoaded = account.ledgerLoaded, deferred = account.ledgerDeferred,
+         path = account.dataFile, journalPath = account.journal.getPath(), sequence, crypto = account.crypto,
+         done = account.backgroundDone]() {
+            Account saved(path, journalPath);
+            saved.crypto = crypto;
+            uint64_t snapshotSequence = 0;
+            std::vector<Mutation> changes;
+            bool read = readSnapshot(saved, snapshotSequence, nullptr, false) == LoginResult::SUCCESS;
+            if (read && deferred) {
+                loaded = saved.ledger;
+                ledgerLoaded = true;
+            }
+            if (read && saved.journal.read(saved.crypto, snapshotSequence, changes) && saved.journal.getLastSequence() == sequence) {
+                for (const Mutation& mutation : changes) {
+                    applyMutation(saved, mutation);
+                }
+                if (writeArchivedSnapshot(path, crypto, saved.dataMap, saved.counterparties, saved.ledger, saved.segments,
+                                          sequence, update)) {
+                    journal.dropThrough(sequence);
+                }
+            }
+            running = false;
+            if (done) done();
+        });
+}
+
+bool startLedgerLoad(Account& account) {
+    if (!account.ledgerDeferred || account.ledgerLoadFailed || account.workerRunning) return false;
+    account.waitForWorker();
+    finishSave(account);
+    if (!account.ledgerDeferred) return false; // A compaction that just finished brought the entries
+
+    account.workerRunning = true;
+    account.workerThread = std::thread([&account, path = account.dataFile, crypto = account.crypto, done = account.backgroundDone]() {
+        // Mapped only while reading, so a later snapshot can still replace the file
+        MappedFile file;
+        BlockReader reader;
+        Ledger base;
+        if (!file.open(path) || !reader.open(file.view(), crypto) || !blocksToLedger(reader, base)) {
+            base = Ledger(); // Fails the entry count check in finishSave, which sets ledgerLoadFailed
+        }
+        account.loadedLedger = std::move(base);
+        account.ledgerLoaded = true;
+        account.workerRunning = false;
+        if (done) done();
+    });
+    return true;
+}
+
+bool startSave(Account& account) {
+    if (account.workerRunning) return false;
+    account.waitForWorker();
+    finishSave(account);
+    if (account.fileExists && account.pendingMutations.empty()) return false;
+
+    // The job owns its batch of mutations, so later edits never race with it
+    account.savingMutations = std::move(account.pendingMutations);
+    account.pendingMutations.clear();
+    account.savingSnapshot = !account.fileExists;
+    account.saveSucceeded = false;
+    account.workerRunning = true;
+
+    if (account.savingSnapshot) {
+        // First save of a new account: the data is still small, so copy it
+        account.workerThread = std::thread(
+            [&account, crypto = account.crypto, dataMap = account.dataMap, counterparties = account.counterparties,
+             ledger = account.ledger, segments = account.segments, done = account.backgroundDone]() {
+                account.saveSucceeded = writeArchivedSnapshot(account.dataFile, crypto, dataMap, counterparties, ledger,
+                                                              segments, 0, account.archiveUpdate);
+                if (account.saveSucceeded) account.journal.remove();
+                account.workerRunning = false;
+                if (done) done();
+            });
+    } else {
+        account.workerThread = std::thread([&account, done = account.backgroundDone]() {
+            account.saveSucceeded = account.journal.append(account.savingMutations, account.crypto);
+            account.workerRunning = false;
+            if (done) done();
+        });
+    }
+    return true;
+}
+
+SaveResult finishSave(Account& account) {
+    if (account.workerRunning) return SaveResult::NONE;
+    account.waitForWorker();
+    applyLoadedLedger(account);
+    applyArchive(account);
+    if (account.savingMutations.empty() && !account.savingSnapshot) return SaveResult::NONE;
+
+    bool saved = account.saveSucceeded;
+    if (saved) {
+        if (account.savingSnapshot) account.fileExists = true;
+    } else {
+        account.pendingMutations.insert(account.pendingMutations.begin(),
+            std::make_move_iterator(account.savingMutations.begin()), std::make_move_iterator(account.savingMutations.end()));
+    }
+    account.savingMutations.clear();
+    account.savingSnapshot = false;
+    return saved ? SaveResult::SAVED : SaveResult::FAILED;
+}
+
+bool startCompactionIfDue(Account& account) {
+    if (account.workerRunning || !account.fileExists || account.journal.getSizeBytes() <= JOURNAL_COMPACT_BYTES) return false;
+    startCompaction(account);
+    return true;
+}
+
+bool passwordMatches(std::string_view saves, const CryptoSession& crypto) {
+    if (isBlockContainer(saves)) return blockKeyMatches(saves, crypto);
+    if (isChunkedContainer(saves)) return chunkedKeyMatches(saves, crypto);
+
+    // Legacy CBC save: the "valid" marker sits in the last block, which only
+    // needs that block and the ciphertext block before it
+    if (saves.size() < 16 || saves.size() % 16 != 0) return false;
+    std::string last(saves.substr(saves.size() - 16));
+    if (!crypto.decryptInPlace(last)) return false;
+    if (saves.size() >= 32) {
+        for (int i = 0; i < 16; i++) last[i] ^= saves[saves.size() - 32 + i];
+    }
+    return last.compare(11, 5, "valid") == 0;
+}
+
+bool writeSnapshot(const std::string& encrypted, const std::string& path) {
+    std::string tempFile = path + ".tmp";
+    if (encrypted.empty() || saveToFile(encrypted, tempFile)) return false;
+    std::error_code ec;
+    std::filesystem::rename(tempFile, path, ec);
+    return !ec;
+}
+
+std::string segmentPath(const std::string& dataFile, int32_t year) {
+    return std::filesystem::path(dataFile).replace_extension(std::to_string(year) + ".ledger").string();
+}
+
+bool archiveClosedYears(const std::string& dataFile, const CryptoSession& crypto, const CounterpartyTable& counterparties,
+                        const Ledger& ledger, const std::vector<LedgerSegment>& segments, ArchiveUpdate& update) {
+    update = ArchiveUpdate{ segments.size(), 0, segments };
+
+    // Runs of entries sharing a period; the last run is the open year
+    struct Period {
+        int32_t year;
+        size_t first;
+        size_t last;
+    };
+    const std::vector<LedgerEntry>& entries = ledger.getEntries();
+    std::vector<Period> periods;
+    int32_t year = segments.empty() ? INT32_MIN : segments.back().year + 1;
+    for (size_t i = 0; i < entries.size(); i++) {
+        year = std::max(year, Ledger::yearOf(entries[i].timestamp));
+        if (periods.empty() || periods.back().year != year) periods.push_back({ year, i, i });
+        periods.back().last = i + 1;
+    }
+    if (periods.size() < 2) return true;
+    periods.pop_back();
+
+    std::vector<Amount> openings;
+    Amount running = ledger.getOpeningBalance();
+    for (const Period& period : periods) {
+        openings.push_back(running);
+        for (size_t i = period.first; i < period.last; i++) running += ledger.amountOf(entries[i]);
+    }
+
+    // Newest closed year first, so the counterparty balances at each year end
+    // come from walking back from today's balances without keeping them all
+    std::vector<Amount> balances;
+    balances.reserve(counterparties.size());
+    for (uint32_t id = 0; id < counterparties.size(); id++) balances.push_back(counterparties.balanceOf(id));
+
+    std::vector<LedgerSegment> closed(periods.size());
+    size_t cursor = entries.size();
+    for (size_t p = periods.size(); p-- > 0;) {
+        const Period& period = periods[p];
+        for (; cursor > period.last; cursor--) {
+            const LedgerEntry& entry = entries[cursor - 1];
+            if (entry.counterparty < balances.size()) balances[entry.counterparty] -= ledger.amountOf(entry);
+        }
+
+        LedgerSegment& segment = closed[p];
+        segment.year = period.year;
+        segment.entryCount = period.last - period.first;
+        segment.minTime = segment.maxTime = entries[period.first].timestamp;
+        for (size_t i = period.first; i < period.last; i++) {
+            segment.minTime = std::min(segment.minTime, entries[i].timestamp);
+            segment.maxTime = std::max(segment.maxTime, entries[i].timestamp);
+        }
+        segment.openingBalance = openings[p];
+        segment.closingBalance = p + 1 < periods.size() ? openings[p + 1] : running;
+
+        Ledger yearLedger = ledger.slice(period.first, period.last, segment.openingBalance);
+        if (!writeSnapshot(segmentToBlocks(segment, yearLedger, balances, crypto), segmentPath(dataFile, segment.year))) {
+            update = ArchiveUpdate{ segments.size(), 0, segments };
+            return false;
+        }
+    }
+
+    update.segments.insert(update.segments.end(), closed.begin(), closed.end());
+    update.archivedEntries = periods.back().last;
+    return true;
+}
+
+bool loadLedgerSegment(const Account& account, size_t index, Ledger& out, std::vector<Amount>* closingBalances) {
+    if (index >= account.segments.size()) return false;
+    const LedgerSegment& expected = account.segments[index];
+
+    MappedFile file;
+    BlockReader reader;
+    LedgerSegment segment;
+    if (!file.open(segmentPath(account.dataFile, expected.year)) || !reader.open(file.view(), account.crypto) ||
+        !blocksToSegment(reader, segment, out, closingBalances)) return false;
+
+    // A file left behind by a save that failed later must not stand in for this year
+    return segment.entryCount == expected.entryCount && segment.year == expected.year &&
+           segment.closingBalance.compare(expected.closingBalance) == 0;
+}
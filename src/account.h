@@ -0,0 +1,156 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "counterparties.h"
+#include "encrypter.h"
+#include "journal.h"
+#include "ledger.h"
+
+const std::string DATA_FILE = "saves.data";
+const std::string JOURNAL_FILE = "saves.journal";
+const uint64_t JOURNAL_COMPACT_BYTES = 1024 * 1024; // Fold the journal into a new snapshot past this size
+
+// Result of moving closed years out of the ledger into segment files
+struct ArchiveUpdate {
+    size_t baseSegments = 0;             // Segments the job started from
+    size_t archivedEntries = 0;          // Entries moved off the front of the ledger
+    std::vector<LedgerSegment> segments; // Every closed year after the move
+};
+
+// Account data plus the load/save pipeline. No GUI dependencies, so it can be
+// driven from benchmarks and tools as well as from main.cpp.
+struct Account {
+    std::map<std::string, std::string> dataMap;  // "Total Money", "Last Transaction", "Short Note"
+    CounterpartyTable counterparties;            // Borrowers/lenders; ids are ledger counterparty ids
+    Ledger ledger;                               // The open year only; closed years live in segment files
+    std::vector<LedgerSegment> segments;         // Closed years, oldest first (loadLedgerSegment reads one)
+    std::string userKey;
+    CryptoSession crypto; // Key schedule expanded once from userKey at login
+
+    // Login leaves a block save's ledger encrypted. Until startLedgerLoad reads
+    // it, ledger holds only the entries made since, starting from the saved
+    // balance, and deferredLedger describes the rest (year unused).
+    bool ledgerDeferred = false;
+    LedgerSegment deferredLedger;
+    bool ledgerLoadFailed = false;
+
+    // Incremental saving
+    std::string dataFile;
+    Journal journal;
+    std::vector<Mutation> pendingMutations; // Applied in memory, written on the next save
+    bool fileExists = false;
+
+    // One background job at a time (autosave or compaction); it owns the
+    // journal and the data file until it is joined
+    std::thread workerThread;
+    std::atomic<bool> workerRunning{ false };
+    std::vector<Mutation> savingMutations;  // Handed to the autosave job
+    bool savingSnapshot = false;            // The autosave job writes the first snapshot
+    bool saveSucceeded = false;             // Set by the autosave job before it finishes
+    ArchiveUpdate archiveUpdate;            // Set by a snapshot job that closed a year, applied by finishSave
+    Ledger loadedLedger;                    // Deferred entries read by a job, merged by finishSave
+    bool ledgerLoaded = false;
+
+    // Called on the worker thread when a background job finishes (the GUI wakes its idle loop)
+    std::function<void()> backgroundDone;
+
+    explicit Account(std::string dataFile = DATA_FILE, std::string journalFile = JOURNAL_FILE)
+        : dataFile(std::move(dataFile)), journal(std::move(journalFile)) {}
+    Account(const Account&) = delete;
+    Account& operator=(const Account&) = delete;
+
+    ~Account() {
+        waitForWorker();
+    }
+
+    void waitForWorker() {
+        if (workerThread.joinable()) {
+            workerThread.join();
+        }
+    }
+};
+
+enum class LoginResult {
+    SUCCESS,
+    READ_ERROR,        // Data file missing or unreadable
+    WRONG_PASSWORD,
+    CORRUPTED,         // Key is right but the save does not parse
+    JOURNAL_CORRUPTED, // A saved change in the journal does not read (the file is left as is)
+    CANCELLED          // LoadProgress::cancelled was set while loading
+};
+
+struct LoadProgress;
+
+// Start a fresh account in memory (written on the first save)
+void createAccount(Account& account, const std::string& password, const std::string& initialMoney);
+
+// Verify the password, decrypt the snapshot and replay the journal. Safe to run
+// on a worker thread as long as nothing else touches the account meanwhile;
+// progress, when given, is updated as it goes and can cancel the load. The
+// ledger of a block save is left on disk (see Account::ledgerDeferred).
+LoginResult loginAccount(Account& account, const std::string& password, LoadProgress* progress = nullptr);
+
+// Apply one change to the in-memory data; shared by live edits and journal replay
+void applyMutation(Account& account, const Mutation& mutation);
+
+// Apply a live change and queue it for the journal
+void recordMutation(Account& account, MutationType type, const std::string& name, const std::string& value);
+
+// Append pending changes to the journal, or write the first snapshot. Waits for
+// a running job first and never starts one, so it is safe right before exit.
+bool saveData(Account& account);
+
+// Fold the journal into a fresh snapshot on a worker thread
+void startCompaction(Account& account);
+
+enum class SaveResult {
+    NONE,     // No autosave has finished since the last call
+    SAVED,
+    FAILED
+};
+
+// Write pending changes (or the first snapshot) on a worker thread. Returns false
+// when there is nothing to save or a background job is still running.
+bool startSave(Account& account);
+
+// Read the ledger entries login left on disk on a worker thread. Returns false
+// when none are deferred, a background job is still running or reading them
+// failed before (ledgerLoadFailed).
+bool startLedgerLoad(Account& account);
+
+// Collect a finished autosave on the UI thread. Changes from a failed save go
+// back in front of pendingMutations so the next save retries them. Also merges
+// deferred ledger entries a job read and trims the ledger after a snapshot job
+// moved closed years into segment files. Never starts a job itself.
+SaveResult finishSave(Account& account);
+
+// Start a compaction when the journal has grown past JOURNAL_COMPACT_BYTES and
+// no job is running; true when one was started
+bool startCompactionIfDue(Account& account);
+
+// Segment file for a closed year, next to the data file ("saves.2024.ledger")
+std::string segmentPath(const std::string& dataFile, int32_t year);
+
+// Write a segment file for every year at the front of ledger that is older than
+// its newest entry. The period of an entry is the latest year seen up to it, so
+// an entry with a skewed clock never reopens a closed year. Fills update with
+// the segments after the move; false on a write error.
+bool archiveClosedYears(const std::string& dataFile, const CryptoSession& crypto, const CounterpartyTable& counterparties,
+                        const Ledger& ledger, const std::vector<LedgerSegment>& segments, ArchiveUpdate& update);
+
+// Read a closed year on demand (history views); closingBalances, when given,
+// receives every counterparty balance at the end of that year by id
+bool loadLedgerSegment(const Account& account, size_t index, Ledger& out, std::vector<Amount>* closingBalances = nullptr);
+
+// Check the password before any bulk decryption, in time independent of the file size
+bool passwordMatches(std::string_view saves, const CryptoSession& crypto);
+
+// Write a snapshot through a temp file so a crash never leaves a half-written save
+bool writeSnapshot(const std::string& encrypted, const std::string& path);
@@ -0,0 +1,373 @@
+#include "aes.h"
+#include "aesHardware.h"
+#include <cstring>
+
+namespace {
+    // Bitsliced S-box (Boyar-Peralta circuit). q[i] holds bit i of up to 32 bytes,
+    // one byte per lane, so every byte goes through the same gates regardless of value.
+    void bitsliceSbox(uint32_t* q) {
+        uint32_t x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4];
+        uint32_t x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+        // Top linear transformation
+        uint32_t y14 = x3 ^ x5;
+        uint32_t y13 = x0 ^ x6;
+        uint32_t y9 = x0 ^ x3;
+        uint32_t y8 = x0 ^ x5;
+        uint32_t t0 = x1 ^ x2;
+        uint32_t y1 = t0 ^ x7;
+        uint32_t y4 = y1 ^ x3;
+        uint32_t y12 = y13 ^ y14;
+        uint32_t y2 = y1 ^ x0;
+        uint32_t y5 = y1 ^ x6;
+        uint32_t y3 = y5 ^ y8;
+        uint32_t t1 = x4 ^ y12;
+        uint32_t y15 = t1 ^ x5;
+        uint32_t y20 = t1 ^ x1;
+        uint32_t y6 = y15 ^ x7;
+        uint32_t y10 = y15 ^ t0;
+        uint32_t y11 = y20 ^ y9;
+        uint32_t y7 = x7 ^ y11;
+        uint32_t y17 = y10 ^ y11;
+        uint32_t y19 = y10 ^ y8;
+        uint32_t y16 = t0 ^ y11;
+        uint32_t y21 = y13 ^ y16;
+        uint32_t y18 = x0 ^ y16;
+
+        // Non-linear section
+        uint32_t t2 = y12 & y15;
+        uint32_t t3 = y3 & y6;
+        uint32_t t4 = t3 ^ t2;
+        uint32_t t5 = y4 & x7;
+        uint32_t t6 = t5 ^ t2;
+        uint32_t t7 = y13 & y16;
+        uint32_t t8 = y5 & y1;
+        uint32_t t9 = t8 ^ t7;
+        uint32_t t10 = y2 & y7;
+        uint32_t t11 = t10 ^ t7;
+        uint32_t t12 = y9 & y11;
+        uint32_t t13 = y14 & y17;
+        uint32_t t14 = t13 ^ t12;
+        uint32_t t15 = y8 & y10;
+        uint32_t t16 = t15 ^ t12;
+        uint32_t t17 = t4 ^ t14;
+        uint32_t t18 = t6 ^ t16;
+        uint32_t t19 = t9 ^ t14;
+        uint32_t t20 = t11 ^ t16;
+        uint32_t t21 = t17 ^ y20;
+        uint32_t t22 = t18 ^ y19;
+        uint32_t t23 = t19 ^ y21;
+        uint32_t t24 = t20 ^ y18;
+
+        uint32_t t25 = t21 ^ t22;
+        uint32_t t26 = t21 & t23;
+        uint32_t t27 = t24 ^ t26;
+        uint32_t t28 = t25 & t27;
+        uint32_t t29 = t28 ^ t22;
+        uint32_t t30 = t23 ^ t24;
+        uint32_t t31 = t22 ^ t26;
+        uint32_t t32 = t31 & t30;
+        uint32_t t33 = t32 ^ t24;
+        uint32_t t34 = t23 ^ t33;
+        uint32_t t35 = t27 ^ t33;
+        uint32_t t36 = t24 & t35;
+        uint32_t t37 = t36 ^ t34;
+        uint32_t t38 = t27 ^ t36;
+        uint32_t t39 = t29 & t38;
+        uint32_t t40 = t25 ^ t39;
+
+        uint32_t t41 = t40 ^ t37;
+        uint32_t t42 = t29 ^ t33;
+        uint32_t t43 = t29 ^ t40;
+        uint32_t t44 = t33 ^ t37;
+        uint32_t t45 = t42 ^ t41;
+        uint32_t z0 = t44 & y15;
+        uint32_t z1 = t37 & y6;
+        uint32_t z2 = t33 & x7;
+        uint32_t z3 = t43 & y16;
+        uint32_t z4 = t40 & y1;
+        uint32_t z5 = t29 & y7;
+        uint32_t z6 = t42 & y11;
+        uint32_t z7 = t45 & y17;
+        uint32_t z8 = t41 & y10;
+        uint32_t z9 = t44 & y12;
+        uint32_t z10 = t37 & y3;
+        uint32_t z11 = t33 & y4;
+        uint32_t z12 = t43 & y13;
+        uint32_t z13 = t40 & y5;
+        uint32_t z14 = t29 & y2;
+        uint32_t z15 = t42 & y9;
+        uint32_t z16 = t45 & y14;
+        uint32_t z17 = t41 & y8;
+
+        // Bottom linear transformation
+        uint32_t t46 = z15 ^ z16;
+        uint32_t t47 = z10 ^ z11;
+        uint32_t t48 = z5 ^ z13;
+        uint32_t t49 = z9 ^ z10;
+        uint32_t t50 = z2 ^ z12;
+        uint32_t t51 = z2 ^ z5;
+        uint32_t t52 = z7 ^ z8;
+        uint32_t t53 = z0 ^ z3;
+        uint32_t t54 = z6 ^ z7;
+        uint32_t t55 = z16 ^ z17;
+        uint32_t t56 = z12 ^ t48;
+        uint32_t t57 = t50 ^ t53;
+        uint32_t t58 = z4 ^ t46;
+        uint32_t t59 = z3 ^ t54;
+        uint32_t t60 = t46 ^ t57;
+        uint32_t t61 = z14 ^ t57;
+        uint32_t t62 = t52 ^ t58;
+        uint32_t t63 = t49 ^ t58;
+        uint32_t t64 = z4 ^ t59;
+        uint32_t t65 = t61 ^ t62;
+        uint32_t t66 = z1 ^ t63;
+        uint32_t s0 = t59 ^ t63;
+        uint32_t s6 = t56 ^ ~t62;
+        uint32_t s7 = t48 ^ ~t60;
+        uint32_t t67 = t64 ^ t65;
+        uint32_t s3 = t53 ^ t66;
+        uint32_t s4 = t51 ^ t66;
+        uint32_t s5 = t47 ^ t65;
+        uint32_t s1 = t64 ^ ~s3;
+        uint32_t s2 = t55 ^ ~t67;
+
+        q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+        q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+    }
+
+    // Inverse of the S-box affine map: x = rotl(y,1) ^ rotl(y,3) ^ rotl(y,6) ^ 0x05
+    void bitsliceInverseAffine(uint32_t* q) {
+        uint32_t r[8];
+        for (int i = 0; i < 8; i++) {
+            r[i] = q[(i + 7) & 7] ^ q[(i + 5) & 7] ^ q[(i + 2) & 7];
+        }
+        r[0] = ~r[0];
+        r[2] = ~r[2];
+        std::memcpy(q, r, sizeof(r));
+    }
+
+    // Transpose an 8x8 bit matrix held as bit (8 * row + column)
+    inline uint64_t transpose8x8(uint64_t x) {
+        uint64_t t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAull;
+        x = x ^ t ^ (t << 7);
+        t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull;
+        x = x ^ t ^ (t << 14);
+        t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull;
+        return x ^ t ^ (t << 28);
+    }
+
+    inline uint64_t loadLanes(const uint8_t* bytes) {
+        uint64_t x = 0;
+        for (int j = 0; j < 8; j++) x |= static_cast<uint64_t>(bytes[j]) << (8 * j);
+        return x;
+    }
+
+    // Substitute up to 32 bytes in place
+    void subBytes(uint8_t* bytes, size_t count, bool inverse) {
+        uint8_t lanes[32] = {};
+        std::memcpy(lanes, bytes, count);
+
+        // Each 8-byte group becomes eight bit planes; plane i of group g lands in bits 8g..8g+7 of q[i]
+        uint32_t q[8] = {};
+        for (int g = 0; g < 4; g++) {
+            uint64_t planes = transpose8x8(loadLanes(lanes + 8 * g));
+            for (int i = 0; i < 8; i++) {
+                q[i] |= static_cast<uint32_t>((planes >> (8 * i)) & 0xFF) << (8 * g);
+            }
+        }
+
+        // InvS(y) = A^-1(S(A^-1(y))) since S(x) = A(x^-1)
+        if (inverse) bitsliceInverseAffine(q);
+        bitsliceSbox(q);
+        if (inverse) bitsliceInverseAffine(q);
+
+        for (int g = 0; g < 4; g++) {
+            uint64_t planes = 0;
+            for (int i = 0; i < 8; i++) {
+                planes |= static_cast<uint64_t>((q[i] >> (8 * g)) & 0xFF) << (8 * i);
+            }
+            uint64_t x = transpose8x8(planes);
+            for (int j = 0; j < 8; j++) lanes[8 * g + j] = static_cast<uint8_t>(x >> (8 * j));
+        }
+        std::memcpy(bytes, lanes, count);
+    }
+
+    inline uint8_t xtime(uint8_t x) {
+        return static_cast<uint8_t>((x << 1) ^ (0x1b & (0u - (x >> 7))));
+    }
+
+    void shiftRows(uint8_t* s) {
+        uint8_t t[16];
+        for (int c = 0; c < 4; c++) {
+            for (int r = 0; r < 4; r++) {
+                t[r + 4 * c] = s[r + 4 * ((c + r) & 3)];
+            }
+        }
+        std::memcpy(s, t, 16);
+    }
+
+    void invShiftRows(uint8_t* s) {
+        uint8_t t[16];
+        for (int c = 0; c < 4; c++) {
+            for (int r = 0; r < 4; r++) {
+                t[r + 4 * ((c + r) & 3)] = s[r + 4 * c];
+            }
+        }
+        std::memcpy(s, t, 16);
+    }
+
+    void mixColumns(uint8_t* s) {
+        for (int c = 0; c < 4; c++) {
+            uint8_t* col = s + 4 * c;
+            uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+            uint8_t all = a0 ^ a1 ^ a2 ^ a3;
+            col[0] = a0 ^ all ^ xtime(a0 ^ a1);
+            col[1] = a1 ^ all ^ xtime(a1 ^ a2);
+            col[2] = a2 ^ all ^ xtime(a2 ^ a3);
+            col[3] = a3 ^ all ^ xtime(a3 ^ a0);
+        }
+    }
+
+    void invMixColumns(uint8_t* s) {
+        // Pre-multiply by {04}x^2 + {05}, then apply the forward MixColumns
+        for (int c = 0; c < 4; c++) {
+            uint8_t* col = s + 4 * c;
+            uint8_t u = xtime(xtime(col[0] ^ col[2]));
+            uint8_t v = xtime(xtime(col[1] ^ col[3]));
+            col[0] ^= u;
+            col[1] ^= v;
+            col[2] ^= u;
+            col[3] ^= v;
+        }
+        mixColumns(s);
+    }
+
+    inline void addRoundKey(uint8_t* s, const uint8_t* k) {
+        for (int i = 0; i < 16; i++) s[i] ^= k[i];
+    }
+
+    // Encrypt one or two independent blocks; two share each bitsliced S-box pass
+    void softwareEncrypt(const AesKey& key, uint8_t* blocks, size_t count) {
+        for (size_t b = 0; b < count; b++) addRoundKey(blocks + 16 * b, key.encRounds[0]);
+        for (int round = 1; round <= 14; round++) {
+            subBytes(blocks, 16 * count, false);
+            for (size_t b = 0; b < count; b++) {
+                uint8_t* s = blocks + 16 * b;
+                shiftRows(s);
+                if (round != 14) mixColumns(s);
+                addRoundKey(s, key.encRounds[round]);
+            }
+        }
+    }
+
+    void softwareDecrypt(const AesKey& key, uint8_t* blocks, size_t count) {
+        for (size_t b = 0; b < count; b++) addRoundKey(blocks + 16 * b, key.encRounds[14]);
+        for (int round = 13; round >= 0; round--) {
+            for (size_t b = 0; b < count; b++) invShiftRows(blocks + 16 * b);
+            subBytes(blocks, 16 * count, true);
+            for (size_t b = 0; b < count; b++) {
+                uint8_t* s = blocks + 16 * b;
+                addRoundKey(s, key.encRounds[round]);
+                if (round != 0) invMixColumns(s);
+            }
+        }
+    }
+}
+
+bool aesHardwareAvailable() {
+#ifdef MONEYTRACKER_AES_X86
+    static const bool supported = aesHardware::cpuSupported();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void aesExpandKey(const uint8_t key[32], AesKey& out, bool forceSoftware) {
+    // AES-256: Nk = 8, Nr = 14, 60 schedule words
+    uint8_t* w = &out.encRounds[0][0];
+    std::memcpy(w, key, 32);
+    uint8_t rcon = 0x01;
+    for (int i = 8; i < 60; i++) {
+        uint8_t temp[4];
+        std::memcpy(temp, w + 4 * (i - 1), 4);
+        if (i % 8 == 0) {
+            uint8_t rotated[4] = { temp[1], temp[2], temp[3], temp[0] };
+            subBytes(rotated, 4, false);
+            temp[0] = rotated[0] ^ rcon;
+            temp[1] = rotated[1];
+            temp[2] = rotated[2];
+            temp[3] = rotated[3];
+            rcon = xtime(rcon);
+        } else if (i % 8 == 4) {
+            subBytes(temp, 4, false);
+        }
+        for (int j = 0; j < 4; j++) {
+            w[4 * i + j] = w[4 * (i - 8) + j] ^ temp[j];
+        }
+    }
+
+    out.hardware = !forceSoftware && aesHardwareAvailable();
+#ifdef MONEYTRACKER_AES_X86
+    if (out.hardware) {
+        aesHardware::deriveDecryptRounds(out.encRounds, out.decRounds);
+    }
+#endif
+}
+
+void aesCbcEncrypt(const AesKey& key, uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blocks) {
+#ifdef MONEYTRACKER_AES_X86
+    if (key.hardware) {
+        aesHardware::cbcEncrypt(key.encRounds, iv, in, out, blocks);
+        return;
+    }
+#endif
+    uint8_t state[16];
+    for (size_t b = 0; b < blocks; b++) {
+        for (int i = 0; i < 16; i++) state[i] = in[16 * b + i] ^ iv[i];
+        softwareEncrypt(key, state, 1);
+        std::memcpy(out + 16 * b, state, 16);
+        std::memcpy(iv, state, 16);
+    }
+}
+
+void aesCbcDecrypt(const AesKey& key, uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blocks) {
+#ifdef MONEYTRACKER_AES_X86
+    if (key.hardware) {
+        aesHardware::cbcDecrypt(key.decRounds, iv, in, out, blocks);
+        return;
+    }
+#endif
+    // CBC decryption has no chaining dependency, so blocks are processed in pairs
+    uint8_t state[32];
+    uint8_t cipher[32];
+    for (size_t b = 0; b < blocks; b += 2) {
+        size_t count = (blocks - b >= 2) ? 2 : 1;
+        std::memcpy(cipher, in + 16 * b, 16 * count);
+        std::memcpy(state, cipher, 16 * count);
+        softwareDecrypt(key, state, count);
+        for (int i = 0; i < 16; i++) state[i] ^= iv[i];
+        if (count == 2) {
+            for (int i = 0; i < 16; i++) state[16 + i] ^= cipher[i];
+        }
+        std::memcpy(out + 16 * b, state, 16 * count);
+        std::memcpy(iv, cipher + 16 * (count - 1), 16);
+    }
+}
+
+void aesEncryptBlocks(const AesKey& key, const uint8_t* in, uint8_t* out, size_t blocks) {
+#ifdef MONEYTRACKER_AES_X86
+    if (key.hardware) {
+        aesHardware::encryptBlocks(key.encRounds, in, out, blocks);
+        return;
+    }
+#endif
+    uint8_t state[32];
+    for (size_t b = 0; b < blocks; b += 2) {
+        size_t count = (blocks - b >= 2) ? 2 : 1;
+        std::memcpy(state, in + 16 * b, 16 * count);
+        softwareEncrypt(key, state, count);
+        std::memcpy(out + 16 * b, state, 16 * count);
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// In-tree AES-256 used by encrypter.cpp.
+// AES-NI kernels are used when the CPU supports them, otherwise a constant-time
+// bitsliced software implementation (no secret-indexed table lookups).
+
+struct AesKey {
+    alignas(16) uint8_t encRounds[15][16];  // Standard key schedule
+    alignas(16) uint8_t decRounds[15][16];  // Equivalent inverse cipher schedule (hardware path only)
+    bool hardware;
+};
+
+// True when the AES-NI kernels are compiled in and supported by this CPU
+bool aesHardwareAvailable();
+
+// Expand a 32-byte key. forceSoftware disables the hardware path (used by benchmarks).
+void aesExpandKey(const uint8_t key[32], AesKey& out, bool forceSoftware = false);
+
+// CBC over whole 16-byte blocks. iv is updated to the last ciphertext block so
+// calls can be chained. in and out may point to the same buffer.
+void aesCbcEncrypt(const AesKey& key, uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blocks);
+void aesCbcDecrypt(const AesKey& key, uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blocks);
+
+// Raw block encryption of independent blocks (building block for counter modes)
+void aesEncryptBlocks(const AesKey& key, const uint8_t* in, uint8_t* out, size_t blocks);
@@ -0,0 +1,131 @@
+#include "aesHardware.h"
+
+#ifdef MONEYTRACKER_AES_X86
+#include <wmmintrin.h>
+#include <emmintrin.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define AES_TARGET
+#else
+#include <cpuid.h>
+#define AES_TARGET __attribute__((target("aes,sse2")))
+#endif
+
+namespace aesHardware {
+
+bool cpuSupported() {
+    unsigned int ecx = 0;
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    ecx = static_cast<unsigned int>(info[2]);
+#else
+    unsigned int eax, ebx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+#endif
+    return (ecx & (1u << 25)) != 0; // AES-NI
+}
+
+AES_TARGET
+void deriveDecryptRounds(const uint8_t encRounds[15][16], uint8_t decRounds[15][16]) {
+    _mm_store_si128(reinterpret_cast<__m128i*>(decRounds[0]), _mm_load_si128(reinterpret_cast<const __m128i*>(encRounds[14])));
+    for (int i = 1; i < 14; i++) {
+        __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(encRounds[14 - i]));
+        _mm_store_si128(reinterpret_cast<__m128i*>(decRounds[i]), _mm_aesimc_si128(k));
+    }
+    _mm_store_si128(reinterpret_cast<__m128i*>(decRounds[14]), _mm_load_si128(reinterpret_cast<const __m128i*>(encRounds[0])));
+}
+
+AES_TARGET
+void cbcEncrypt(const uint8_t encRounds[15][16], uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blocks) {
+    __m128i k[15];
+    for (int i = 0; i < 15; i++) k[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(encRounds[i]));
+
+    __m128i chain = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    for (size_t b = 0; b < blocks; b++) {
+        __m128i s = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * b)), chain);
+        s = _mm_xor_si128(s, k[0]);
+        for (int r = 1; r < 14; r++) s = _mm_aesenc_si128(s, k[r]);
+        chain = _mm_aesenclast_si128(s, k[14]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * b), chain);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), chain);
+}
+
+AES_TARGET
+void cbcDecrypt(const uint8_t decRounds[15][16], uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blocks) {
+    __m128i k[15];
+    for (int i = 0; i < 15; i++) k[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(decRounds[i]));
+
+    __m128i chain = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    size_t b = 0;
+
+    // Blocks are independent when decrypting, so keep four in flight to hide aesdec latency
+    for (; b + 4 <= blocks; b += 4) {
+        __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * b));
+        __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * (b + 1)));
+        __m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * (b + 2)));
+        __m128i c3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * (b + 3)));
+        __m128i s0 = _mm_xor_si128(c0, k[0]);
+        __m128i s1 = _mm_xor_si128(c1, k[0]);
+        __m128i s2 = _mm_xor_si128(c2, k[0]);
+        __m128i s3 = _mm_xor_si128(c3, k[0]);
+        for (int r = 1; r < 14; r++) {
+            s0 = _mm_aesdec_si128(s0, k[r]);
+            s1 = _mm_aesdec_si128(s1, k[r]);
+            s2 = _mm_aesdec_si128(s2, k[r]);
+            s3 = _mm_aesdec_si128(s3, k[r]);
+        }
+        s0 = _mm_xor_si128(_mm_aesdeclast_si128(s0, k[14]), chain);
+        s1 = _mm_xor_si128(_mm_aesdeclast_si128(s1, k[14]), c0);
+        s2 = _mm_xor_si128(_mm_aesdeclast_si128(s2, k[14]), c1);
+        s3 = _mm_xor_si128(_mm_aesdeclast_si128(s3, k[14]), c2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * b), s0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * (b + 1)), s1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * (b + 2)), s2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * (b + 3)), s3);
+        chain = c3;
+    }
+    for (; b < blocks; b++) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * b));
+        __m128i s = _mm_xor_si128(c, k[0]);
+        for (int r = 1; r < 14; r++) s = _mm_aesdec_si128(s, k[r]);
+        s = _mm_xor_si128(_mm_aesdeclast_si128(s, k[14]), chain);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * b), s);
+        chain = c;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), chain);
+}
+
+AES_TARGET
+void encryptBlocks(const uint8_t encRounds[15][16], const uint8_t* in, uint8_t* out, size_t blocks) {
+    __m128i k[15];
+    for (int i = 0; i < 15; i++) k[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(encRounds[i]));
+
+    size_t b = 0;
+    for (; b + 4 <= blocks; b += 4) {
+        __m128i s0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * b)), k[0]);
+        __m128i s1 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * (b + 1))), k[0]);
+        __m128i s2 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * (b + 2))), k[0]);
+        __m128i s3 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * (b + 3))), k[0]);
+        for (int r = 1; r < 14; r++) {
+            s0 = _mm_aesenc_si128(s0, k[r]);
+            s1 = _mm_aesenc_si128(s1, k[r]);
+            s2 = _mm_aesenc_si128(s2, k[r]);
+            s3 = _mm_aesenc_si128(s3, k[r]);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * b), _mm_aesenclast_si128(s0, k[14]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * (b + 1)), _mm_aesenclast_si128(s1, k[14]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * (b + 2)), _mm_aesenclast_si128(s2, k[14]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * (b + 3)), _mm_aesenclast_si128(s3, k[14]));
+    }
+    for (; b < blocks; b++) {
+        __m128i s = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * b)), k[0]);
+        for (int r = 1; r < 14; r++) s = _mm_aesenc_si128(s, k[r]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * b), _mm_aesenclast_si128(s, k[14]));
+    }
+}
+
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// AES-NI kernels, only built for x86 targets. Callers go through aes.h.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MONEYTRACKER_AES_X86 1
+
+namespace aesHardware {
+    bool cpuSupported();
+    void deriveDecryptRounds(const uint8_t encRounds[15][16], uint8_t decRounds[15][16]);
+    void cbcEncrypt(const uint8_t encRounds[15][16], uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blocks);
+    void cbcDecrypt(const uint8_t decRounds[15][16], uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blocks);
+    void encryptBlocks(const uint8_t encRounds[15][16], const uint8_t* in, uint8_t* out, size_t blocks);
+}
+#endif
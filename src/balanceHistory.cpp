@@ -0,0 +1,146 @@
+#include "balanceHistory.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    const double UNITS_PER_CURRENCY = 100.0;  // Amount is Money<2>
+
+    void merge(BalanceRange& into, const BalanceRange& range) {
+        into.low = std::min(into.low, range.low);
+        into.high = std::max(into.high, range.high);
+        into.close = range.close;
+    }
+
+    // Signed value of one entry, without building an Amount on the fast path
+    double entryValue(const Ledger& ledger, const LedgerEntry& entry) {
+        if (entry.flags & Ledger::ENTRY_BIG_AMOUNT) return BalanceHistory::toValue(ledger.amountOf(entry));
+        double value = static_cast<double>(entry.amount) / UNITS_PER_CURRENCY;
+        return entry.direction == EntryDirection::MONEY_OUT ? -value : value;
+    }
+}
+
+double BalanceHistory::toValue(const Amount& amount) {
+    if (amount.isFast()) return static_cast<double>(amount.rawUnits()) / UNITS_PER_CURRENCY;
+    return std::strtod(amount.toString().c_str(), nullptr);
+}
+
+void BalanceHistory::clear() {
+    levels.clear();
+    count = 0;
+    opening = 0.0;
+    running = Amount();
+    syncedOpening = Amount();
+    syncedFirstTime = 0;
+}
+
+size_t BalanceHistory::spanOf(size_t level) const {
+    size_t span = BASE_SPAN;
+    for (size_t i = 0; i < level; i++) span *= FAN_OUT;
+    return span;
+}
+
+bool BalanceHistory::sync(const Ledger& ledger) {
+    const std::vector<LedgerEntry>& entries = ledger.getEntries();
+    bool replaced = entries.size() < count || ledger.getOpeningBalance().compare(syncedOpening) != 0 ||
+                    (count > 0 && entries[0].timestamp != syncedFirstTime);
+    bool rebuilt = replaced || levels.empty();
+    if (rebuilt) {
+        clear();
+        levels.emplace_back();
+        syncedOpening = ledger.getOpeningBalance();
+        running = syncedOpening;
+        opening = toValue(running);
+        if (!entries.empty()) syncedFirstTime = entries[0].timestamp;
+    }
+    if (entries.size() == count) return rebuilt;
+
+    // Fill the base level first; levels above are merged once per call
+    std::vector<BalanceRange>& base = levels[0];
+    size_t firstChanged = count / BASE_SPAN;
+    for (size_t i = count; i < entries.size(); i++) {
+        const LedgerEntry& entry = entries[i];
+        if (entry.flags & Ledger::ENTRY_BIG_AMOUNT) {
+            running += ledger.amountOf(entry);
+        } else {
+            running += Amount::fromUnits(entry.direction == EntryDirection::MONEY_OUT ? -entry.amount : entry.amount);
+        }
+        double value = toValue(running);
+        if (i % BASE_SPAN == 0) {
+            base.push_back({ value, value, value });
+        } else {
+            merge(base.back(), { value, value, value });
+        }
+    }
+    count = entries.size();
+
+    // Re-merge the ranges above what changed, adding levels until the top is a single range
+    for (size_t level = 1; level < levels.size() || levels[level - 1].size() > 1; level++) {
+        if (level == levels.size()) levels.emplace_back();
+        const std::vector<BalanceRange>& below = levels[level - 1];
+        std::vector<BalanceRange>& ranges = levels[level];
+        firstChanged /= FAN_OUT;
+        ranges.resize(firstChanged);
+        for (size_t i = firstChanged * FAN_OUT; i < below.size(); i++) {
+            if (i % FAN_OUT == 0) {
+                ranges.push_back(below[i]);
+            } else {
+                merge(ranges.back(), below[i]);
+            }
+        }
+    }
+    return rebuilt;
+}
+
+double BalanceHistory::balanceAfter(const Ledger& ledger, size_t index) const {
+    size_t bucket = index / BASE_SPAN;
+    double value = bucket == 0 ? opening : levels[0][bucket - 1].close;
+    const std::vector<LedgerEntry>& entries = ledger.getEntries();
+    for (size_t i = bucket * BASE_SPAN; i <= index; i++) {
+        value += entryValue(ledger, entries[i]);
+    }
+    return value;
+}
+
+void BalanceHistory::sample(const Ledger& ledger, size_t first, size_t last, size_t columns, std::vector<BalanceRange>& out) const {
+    out.clear();
+    last = std::min(last, count);
+    if (first >= last || columns == 0) return;
+    size_t total = last - first;
+    columns = std::min(columns, total);
+    size_t perColumn = total / columns;
+    out.resize(columns);
+
+    if (perColumn < BASE_SPAN) {
+        // Zoomed in: walk the few entries on screen
+        const std::vector<LedgerEntry>& entries = ledger.getEntries();
+        double value = first == 0 ? opening : balanceAfter(ledger, first - 1);
+        size_t index = first;
+        for (size_t column = 0; column < columns; column++) {
+            size_t end = first + (column + 1) * total / columns;
+            value += entryValue(ledger, entries[index++]);
+            BalanceRange range = { value, value, value };
+            while (index < end) {
+                value += entryValue(ledger, entries[index++]);
+                merge(range, { value, value, value });
+            }
+            out[column] = range;
+        }
+        return;
+    }
+
+    // Coarsest level with at least one range per column; a column then merges
+    // fewer than FAN_OUT + 2 ranges (partial ranges at the edges included)
+    size_t level = 0;
+    while (level + 1 < levels.size() && spanOf(level + 1) <= perColumn) level++;
+    size_t span = spanOf(level);
+    const std::vector<BalanceRange>& ranges = levels[level];
+    for (size_t column = 0; column < columns; column++) {
+        size_t begin = first + column * total / columns;
+        size_t end = first + (column + 1) * total / columns;
+        BalanceRange range = ranges[begin / span];
+        for (size_t bucket = begin / span + 1; bucket <= (end - 1) / span; bucket++) {
+            merge(range, ranges[bucket]);
+        }
+        out[column] = range;
+    }
+}
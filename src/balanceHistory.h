@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ledger.h"
+
+// Balance range covered by a run of ledger entries, in whole currency units
+struct BalanceRange {
+    double low = 0.0;
+    double high = 0.0;
+    double close = 0.0;  // Balance after the last entry of the run
+};
+
+// Multi-resolution summary of the running balance for charting. Level 0 holds
+// one range per BASE_SPAN entries and every level above merges FAN_OUT ranges
+// of the one below, so any span of the history can be drawn from at most a few
+// ranges per pixel column. Kept in step with the ledger by sync(), which only
+// reads entries appended since the previous call.
+class BalanceHistory {
+public:
+    static constexpr size_t BASE_SPAN = 16;
+    static constexpr size_t FAN_OUT = 4;
+
+    void clear();
+
+    // Catch up with the ledger. Returns true when it was reset, loaded or
+    // trimmed since the last call and the summary was rebuilt from scratch.
+    bool sync(const Ledger& ledger);
+
+    // Entries covered (equals the ledger size after sync)
+    size_t size() const { return count; }
+    double openingValue() const { return opening; }
+
+    // Summarise entries [first, last) into at most columns ranges of equal entry
+    // count. Costs O(columns) from the pyramid; spans narrower than BASE_SPAN
+    // entries per column are read from the ledger directly.
+    void sample(const Ledger& ledger, size_t first, size_t last, size_t columns, std::vector<BalanceRange>& out) const;
+
+    // Balance after entry index (index < size())
+    double balanceAfter(const Ledger& ledger, size_t index) const;
+
+    // Chart value of an amount (rounded to double, exact for cents below 2^53)
+    static double toValue(const Amount& amount);
+
+private:
+    std::vector<std::vector<BalanceRange>> levels;  // levels[k] covers BASE_SPAN * FAN_OUT^k entries per range
+    size_t count = 0;
+    double opening = 0.0;
+    Amount running;
+
+    // What the pyramid was built from, to notice a replaced ledger
+    Amount syncedOpening;
+    int64_t syncedFirstTime = 0;
+
+    size_t spanOf(size_t level) const;
+};
@@ -0,0 +1,245 @@
+#include "bigNumber.h"
+#include <cctype>
+
+namespace {
+    const uint32_t POW10[] = { 1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u };
+}
+
+BigNumber::BigNumber(const std::string& str) : scale(0), negative(false) {
+    if (str.empty() || str == "0") return;
+
+    size_t start = (str[0] == '-') ? 1 : 0;
+
+    // Validate that it's all digits (allow one decimal point)
+    size_t decimal = std::string::npos;
+    for (size_t i = start; i < str.size(); i++) {
+        char c = str[i];
+        if (c == '.') {
+            if (decimal != std::string::npos) return;
+            decimal = i;
+        } else if (!std::isdigit(static_cast<unsigned char>(c))) {
+            return;
+        }
+    }
+
+    scale = (decimal == std::string::npos) ? 0 : static_cast<uint32_t>(str.size() - decimal - 1);
+
+    // Walk digits from the least significant end, packing 9 at a time
+    size_t digitCount = str.size() - start - (decimal == std::string::npos ? 0 : 1);
+    limbs.reserve(digitCount / LIMB_DIGITS + 1);
+
+    uint32_t limb = 0;
+    int filled = 0;
+    for (size_t i = str.size(); i-- > start;) {
+        if (i == decimal) continue;
+        limb += static_cast<uint32_t>(str[i] - '0') * POW10[filled];
+        if (++filled == LIMB_DIGITS) {
+            limbs.push_back(limb);
+            limb = 0;
+            filled = 0;
+        }
+    }
+    if (filled > 0) limbs.push_back(limb);
+
+    negative = (start == 1);
+    normalize();
+}
+
+BigNumber::BigNumber(long long val) : scale(0), negative(val < 0) {
+    unsigned long long magnitude = negative ? 0ull - static_cast<unsigned long long>(val) : static_cast<unsigned long long>(val);
+    while (magnitude > 0) {
+        limbs.push_back(static_cast<uint32_t>(magnitude % LIMB_BASE));
+        magnitude /= LIMB_BASE;
+    }
+}
+
+void BigNumber::normalize() {
+    while (!limbs.empty() && limbs.back() == 0) {
+        limbs.pop_back();
+    }
+    if (limbs.empty()) negative = false;
+}
+
+void BigNumber::rescale(uint32_t newScale) {
+    if (newScale <= scale) return;
+    uint32_t shift = newScale - scale;
+    scale = newScale;
+    if (limbs.empty()) return;
+
+    // Whole limbs first, then the remaining 0-8 digits
+    if (shift >= static_cast<uint32_t>(LIMB_DIGITS)) {
+        limbs.insert(limbs.begin(), shift / LIMB_DIGITS, 0u);
+        shift %= LIMB_DIGITS;
+    }
+    if (shift > 0) {
+        uint64_t carry = 0;
+        for (uint32_t& limb : limbs) {
+            uint64_t cur = static_cast<uint64_t>(limb) * POW10[shift] + carry;
+            limb = static_cast<uint32_t>(cur % LIMB_BASE);
+            carry = cur / LIMB_BASE;
+        }
+        if (carry > 0) limbs.push_back(static_cast<uint32_t>(carry));
+    }
+}
+
+int BigNumber::compareLimbs(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+int BigNumber::compareAbs(const BigNumber& other) const {
+    if (scale == other.scale) return compareLimbs(limbs, other.limbs);
+    if (scale < other.scale) {
+        BigNumber aligned = *this;
+        aligned.rescale(other.scale);
+        return compareLimbs(aligned.limbs, other.limbs);
+    }
+    BigNumber aligned = other;
+    aligned.rescale(scale);
+    return compareLimbs(limbs, aligned.limbs);
+}
+
+void BigNumber::addLimbs(std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    if (a.size() < b.size()) a.resize(b.size(), 0u);
+    uint32_t carry = 0;
+    size_t i = 0;
+    for (; i < b.size(); i++) {
+        uint32_t sum = a[i] + b[i] + carry;
+        carry = sum >= LIMB_BASE ? 1u : 0u;
+        a[i] = carry ? sum - LIMB_BASE : sum;
+    }
+    for (; carry && i < a.size(); i++) {
+        if (++a[i] == LIMB_BASE) {
+            a[i] = 0;
+        } else {
+            carry = 0;
+        }
+    }
+    if (carry) a.push_back(1u);
+}
+
+void BigNumber::subtractLimbs(std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    uint32_t borrow = 0;
+    size_t i = 0;
+    for (; i < b.size(); i++) {
+        uint32_t sub = b[i] + borrow;
+        borrow = a[i] < sub ? 1u : 0u;
+        a[i] = borrow ? a[i] + LIMB_BASE - sub : a[i] - sub;
+    }
+    for (; borrow && i < a.size(); i++) {
+        if (a[i] == 0) {
+            a[i] = LIMB_BASE - 1;
+        } else {
+            a[i]--;
+            borrow = 0;
+        }
+    }
+}
+
+void BigNumber::subtractLimbsReversed(std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    a.resize(b.size(), 0u);
+    uint32_t borrow = 0;
+    for (size_t i = 0; i < b.size(); i++) {
+        uint32_t sub = a[i] + borrow;
+        borrow = b[i] < sub ? 1u : 0u;
+        a[i] = borrow ? b[i] + LIMB_BASE - sub : b[i] - sub;
+    }
+}
+
+void BigNumber::addSigned(const BigNumber& other, bool flipSign) {
+    if (other.isZero()) return;
+
+    bool otherNegative = other.negative != flipSign;
+    if (scale < other.scale) rescale(other.scale);
+
+    // Only the operand with fewer decimal places needs widening
+    const std::vector<uint32_t>* rhs = &other.limbs;
+    BigNumber aligned;
+    if (other.scale < scale) {
+        aligned = other;
+        aligned.rescale(scale);
+        rhs = &aligned.limbs;
+    }
+
+    if (negative == otherNegative || limbs.empty()) {
+        // Same signs: add absolute values
+        addLimbs(limbs, *rhs);
+        negative = otherNegative;
+    } else {
+        // Different signs: subtract absolute values
+        int cmp = compareLimbs(limbs, *rhs);
+        if (cmp == 0) {
+            limbs.clear();
+        } else if (cmp > 0) {
+            subtractLimbs(limbs, *rhs);
+        } else {
+            subtractLimbsReversed(limbs, *rhs);
+            negative = otherNegative;
+        }
+    }
+
+    normalize();
+}
+
+std::string BigNumber::toString() const {
+    if (isZero()) return "0";
+
+    // Digits of the integer magnitude, most significant limb unpadded
+    std::string digits;
+    digits.reserve(limbs.size() * LIMB_DIGITS + scale + 3);
+    digits = std::to_string(limbs.back());
+    for (size_t i = limbs.size() - 1; i-- > 0;) {
+        char buf[LIMB_DIGITS];
+        uint32_t limb = limbs[i];
+        for (int d = LIMB_DIGITS - 1; d >= 0; d--) {
+            buf[d] = static_cast<char>('0' + limb % 10);
+            limb /= 10;
+        }
+        digits.append(buf, LIMB_DIGITS);
+    }
+
+    if (scale > 0) {
+        if (digits.size() <= scale) {
+            digits.insert(0, scale - digits.size() + 1, '0');
+        }
+        digits.insert(digits.size() - scale, 1, '.');
+
+        // Remove trailing zeros from fractional part
+        while (digits.back() == '0') digits.pop_back();
+        if (digits.back() == '.') digits.pop_back();
+    }
+
+    if (negative) digits.insert(0, 1, '-');
+    return digits;
+}
+
+int BigNumber::compare(const BigNumber& other) const {
+    if (isNegative() != other.isNegative()) return isNegative() ? -1 : 1;
+    int cmp = compareAbs(other);
+    return isNegative() ? -cmp : cmp;
+}
+
+BigNumber BigNumber::operator+(const BigNumber& other) const {
+    BigNumber result = *this;
+    result.addSigned(other, false);
+    return result;
+}
+
+BigNumber BigNumber::operator-(const BigNumber& other) const {
+    BigNumber result = *this;
+    result.addSigned(other, true);
+    return result;
+}
+
+BigNumber& BigNumber::operator+=(const BigNumber& other) {
+    addSigned(other, false);
+    return *this;
+}
+
+BigNumber& BigNumber::operator-=(const BigNumber& other) {
+    addSigned(other, true);
+    return *this;
+}
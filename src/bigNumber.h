@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Big Number class for handling arbitrarily large numbers
+// Stored as base 10^9 limbs (least significant first) with an explicit decimal scale,
+// so the value is limbs * 10^-scale.
+class BigNumber {
+private:
+    static constexpr uint32_t LIMB_BASE = 1000000000u;
+    static constexpr int LIMB_DIGITS = 9;
+
+    std::vector<uint32_t> limbs;
+    uint32_t scale;
+    bool negative;
+
+    // Remove high zero limbs
+    void normalize();
+
+    // Multiply the magnitude by 10^digits and raise the scale to match
+    void rescale(uint32_t newScale);
+
+    // Compare absolute values (returns: -1 if this < other, 0 if equal, 1 if this > other)
+    // Both operands must already share the same scale
+    static int compareLimbs(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+    int compareAbs(const BigNumber& other) const;
+
+    static void addLimbs(std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+    // Subtract b from a in place (assumes a >= b)
+    static void subtractLimbs(std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+    // Replace a with b - a in place (assumes b > a)
+    static void subtractLimbsReversed(std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+    // Add other (or its negation when flipSign is set) into this value
+    void addSigned(const BigNumber& other, bool flipSign);
+
+public:
+    BigNumber() : scale(0), negative(false) {}
+    BigNumber(const std::string& str);
+    BigNumber(long long val);
+
+    std::string toString() const;
+
+    bool isZero() const { return limbs.empty(); }
+    bool isNegative() const { return negative && !isZero(); }
+
+    // Signed comparison (returns: -1 if this < other, 0 if equal, 1 if this > other)
+    int compare(const BigNumber& other) const;
+
+    BigNumber operator+(const BigNumber& other) const;
+    BigNumber operator-(const BigNumber& other) const;
+    BigNumber& operator+=(const BigNumber& other);
+    BigNumber& operator-=(const BigNumber& other);
+};
@@ -0,0 +1,199 @@
+#include "blockContainer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <thread>
+
+#include "crc32c.h"
+
+namespace {
+    const char BLOCK_MAGIC[8] = { 'M', 'T', 'B', 'L', 'O', 'C', 'K', '1' };
+    const uint32_t BLOCK_VERSION = 1;
+
+    struct BlockHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t blockCount;
+        uint8_t nonce[8];      // Fresh per save so the keystream is never reused
+        uint64_t indexOffset;  // The index runs from here to the end of the container
+        uint32_t indexCrc;     // CRC-32C of the encrypted index
+        uint32_t reserved;
+        uint8_t keyCheck[16];  // E(nonce || 0xFF..FF), rejects a wrong key before any block is read
+    };
+
+    static_assert(sizeof(BlockHeader) == 56, "BlockHeader layout changed");
+
+    // Each block gets its own 2^36-block (1 TiB) slice of the counter space, so
+    // blocks decrypt independently. The index uses the slot after the last
+    // block, and the key check the very last counter, which no block can reach.
+    const unsigned COUNTER_SHIFT = 36;
+    const uint32_t MAX_BLOCKS = (1u << (64 - COUNTER_SHIFT)) - 2;
+    const uint64_t KEY_CHECK_BLOCK = ~0ull;
+
+    uint64_t firstCounter(size_t block) {
+        return static_cast<uint64_t>(block) << COUNTER_SHIFT;
+    }
+
+    void computeKeyCheck(const CryptoSession& crypto, const uint8_t nonce[8], uint8_t out[16]) {
+        uint8_t zero[16] = { 0 };
+        crypto.ctrXor(nonce, KEY_CHECK_BLOCK, zero, out, sizeof(zero));
+    }
+
+    bool readHeader(std::string_view data, BlockHeader& header) {
+        if (!isBlockContainer(data)) return false;
+        std::memcpy(&header, data.data(), sizeof(header));
+        return header.version <= BLOCK_VERSION;
+    }
+
+    bool keyCheckMatches(const CryptoSession& crypto, const BlockHeader& header) {
+        if (!crypto.isReady()) return false;
+        uint8_t expected[16];
+        computeKeyCheck(crypto, header.nonce, expected);
+        uint8_t diff = 0; // Constant-time compare
+        for (int i = 0; i < 16; i++) diff |= expected[i] ^ header.keyCheck[i];
+        return diff == 0;
+    }
+
+    // Run job(i) for i in [0, count) on up to threads workers; stops early once a job fails
+    template <typename Job>
+    bool forEachParallel(size_t count, unsigned threads, Job job) {
+        if (count == 0) return true;
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+
+        std::atomic<size_t> next{ 0 };
+        std::atomic<bool> ok{ true };
+        auto worker = [&]() {
+            for (size_t i = next++; i < count && ok; i = next++) {
+                if (!job(i)) ok = false;
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+        worker();
+        for (std::thread& thread : pool) thread.join();
+        return ok;
+    }
+}
+
+
+bool isBlockContainer(std::string_view data) {
+    return data.size() >= sizeof(BlockHeader) && std::memcmp(data.data(), BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) == 0;
+}
+
+
+bool blockKeyMatches(std::string_view container, const CryptoSession& crypto) {
+    BlockHeader header;
+    return readHeader(container, header) && keyCheckMatches(crypto, header);
+}
+
+
+void BlockWriter::add(const BlockInfo& info, std::string plaintext) {
+    infos.push_back(info);
+    plaintexts.push_back(std::move(plaintext));
+}
+
+
+std::string BlockWriter::seal(const CryptoSession& crypto, unsigned threads) {
+    if (!crypto.isReady() || infos.size() > MAX_BLOCKS) return "";
+
+    BlockHeader header{};
+    std::memcpy(header.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+    header.version = BLOCK_VERSION;
+    header.blockCount = static_cast<uint32_t>(infos.size());
+    std::random_device random;
+    for (int i = 0; i < 8; i += 4) {
+        uint32_t value = random();
+        std::memcpy(header.nonce + i, &value, 4);
+    }
+    computeKeyCheck(crypto, header.nonce, header.keyCheck);
+
+    uint64_t offset = sizeof(header);
+    for (size_t i = 0; i < infos.size(); i++) {
+        infos[i].offset = offset;
+        infos[i].size = plaintexts[i].size();
+        offset += plaintexts[i].size();
+    }
+    header.indexOffset = offset;
+    size_t indexBytes = infos.size() * sizeof(BlockInfo);
+
+    std::string result(static_cast<size_t>(offset) + indexBytes, '\0');
+    uint8_t* out = reinterpret_cast<uint8_t*>(&result[0]);
+    bool ok = forEachParallel(infos.size(), threads, [&](size_t i) {
+        uint8_t* cipher = out + infos[i].offset;
+        if (!crypto.ctrXor(header.nonce, firstCounter(i), plaintexts[i].data(), cipher, plaintexts[i].size())) return false;
+        infos[i].crc = crc32c(cipher, plaintexts[i].size());
+        return true;
+    });
+    if (!ok) return "";
+
+    uint8_t* index = out + header.indexOffset;
+    if (!crypto.ctrXor(header.nonce, firstCounter(infos.size()), infos.data(), index, indexBytes)) return "";
+    header.indexCrc = crc32c(index, indexBytes);
+    std::memcpy(out, &header, sizeof(header));
+
+    infos.clear();
+    plaintexts.clear();
+    return result;
+}
+
+
+bool BlockReader::open(std::string_view data, const CryptoSession& session) {
+    infos.clear();
+    BlockHeader header;
+    if (!readHeader(data, header) || !keyCheckMatches(session, header)) return false;
+
+    uint64_t indexBytes = static_cast<uint64_t>(header.blockCount) * sizeof(BlockInfo);
+    if (header.blockCount > MAX_BLOCKS || header.indexOffset < sizeof(header) ||
+        header.indexOffset > data.size() || data.size() - header.indexOffset != indexBytes) return false;
+
+    const char* index = data.data() + header.indexOffset;
+    if (crc32c(index, static_cast<size_t>(indexBytes)) != header.indexCrc) return false;
+    infos.resize(header.blockCount);
+    if (!session.ctrXor(header.nonce, firstCounter(header.blockCount), index, infos.data(), static_cast<size_t>(indexBytes))) return false;
+
+    // Blocks must sit between the header and the index
+    for (const BlockInfo& info : infos) {
+        if (info.offset < sizeof(header) || info.offset > header.indexOffset || info.size > header.indexOffset - info.offset) {
+            infos.clear();
+            return false;
+        }
+    }
+
+    container = data;
+    crypto = &session;
+    std::memcpy(nonce, header.nonce, sizeof(nonce));
+    return true;
+}
+
+
+bool BlockReader::decryptBlock(size_t block, void* out) const {
+    const BlockInfo& info = infos[block];
+    const char* cipher = container.data() + info.offset;
+    if (crc32c(cipher, static_cast<size_t>(info.size)) != info.crc) return false;
+    return crypto->ctrXor(nonce, firstCounter(block), cipher, out, static_cast<size_t>(info.size));
+}
+
+
+bool BlockReader::read(size_t block, std::string& out) const {
+    if (block >= infos.size()) return false;
+    out.resize(static_cast<size_t>(infos[block].size));
+    return out.empty() || decryptBlock(block, &out[0]);
+}
+
+
+bool BlockReader::readInto(const std::vector<Target>& targets, unsigned threads,
+                           std::atomic<uint64_t>* bytesDone, const std::atomic<bool>* cancel) const {
+    for (const Target& target : targets) {
+        if (target.block >= infos.size()) return false;
+    }
+    return forEachParallel(targets.size(), threads, [&](size_t i) {
+        if (cancel && *cancel) return false;
+        const Target& target = targets[i];
+        if (!decryptBlock(target.block, target.out)) return false;
+        if (bytesDone) *bytesDone += infos[target.block].size;
+        return true;
+    });
+}
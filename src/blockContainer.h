@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "encrypter.h"
+
+// Block container for save files: independently encrypted (AES-256-CTR) and
+// CRC-32C checked blocks followed by an encrypted index, so a reader can open
+// one block without touching the others.
+// Layout: [56-byte header][block]...[index], the header locating the index.
+
+// Index entry for one block. Everything but offset, size and crc is chosen by the writer.
+struct BlockInfo {
+    uint32_t kind;
+    uint32_t crc;      // CRC-32C of the ciphertext
+    uint64_t offset;   // From the start of the container
+    uint64_t size;
+    uint64_t first;    // Kind-specific position of the first record (id, entry index)
+    uint64_t count;    // Records in the block
+    int64_t minTime;   // Timestamp range of the records, 0 when not applicable
+    int64_t maxTime;
+};
+
+static_assert(sizeof(BlockInfo) == 56, "BlockInfo layout changed");
+
+class BlockWriter {
+public:
+    // Queue a block; info.offset, size and crc are filled in by seal()
+    void add(const BlockInfo& info, std::string plaintext);
+
+    // Encrypt every block (spread across threads) and assemble the container.
+    // Empty string on error. threads = 0 uses every hardware thread.
+    std::string seal(const CryptoSession& crypto, unsigned threads = 0);
+
+private:
+    std::vector<BlockInfo> infos;
+    std::vector<std::string> plaintexts;
+};
+
+class BlockReader {
+public:
+    // One block to decrypt into caller memory of blocks()[block].size bytes
+    struct Target {
+        size_t block;
+        void* out;
+    };
+
+    // Check the key and decrypt the index. container and crypto must outlive the reader.
+    bool open(std::string_view container, const CryptoSession& crypto);
+
+    const std::vector<BlockInfo>& blocks() const { return infos; }
+
+    // Verify the checksum and decrypt one block
+    bool read(size_t block, std::string& out) const;
+
+    // Verify and decrypt several blocks on all cores. bytesDone grows as blocks
+    // finish; setting cancel stops the remaining blocks and fails the call.
+    bool readInto(const std::vector<Target>& targets, unsigned threads = 0,
+                  std::atomic<uint64_t>* bytesDone = nullptr, const std::atomic<bool>* cancel = nullptr) const;
+
+private:
+    std::string_view container;
+    const CryptoSession* crypto = nullptr;
+    uint8_t nonce[8] = { 0 };
+    std::vector<BlockInfo> infos;
+
+    bool decryptBlock(size_t block, void* out) const;
+};
+
+bool isBlockContainer(std::string_view data);
+bool blockKeyMatches(std::string_view container, const CryptoSession& crypto);
@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <limits>
+
+#include "counterparties.h"
+
+namespace {
+    const int KEY_DECIMALS = 2; // Amount is Money<2>
+}
+
+uint64_t CounterpartyTable::hashName(std::string_view name) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Slot holding name, or the empty slot where it would go
+size_t CounterpartyTable::probe(std::string_view name, uint64_t hash) const {
+    size_t mask = slots.size() - 1;
+    uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        const Slot& entry = slots[slot];
+        if (entry.id == EMPTY_SLOT || (entry.tag == tag && names[entry.id] == name)) {
+            return slot;
+        }
+    }
+}
+
+uint32_t CounterpartyTable::find(std::string_view name) const {
+    if (slots.empty()) return NOT_FOUND;
+    size_t slot = probe(name, hashName(name));
+    return slots[slot].id == EMPTY_SLOT ? NOT_FOUND : slots[slot].id;
+}
+
+uint32_t CounterpartyTable::findOrAdd(std::string_view name) {
+    // Keep the load factor at or below 1/2 so probe runs stay short
+    if ((names.size() + 1) * 2 > slots.size()) {
+        rebuildIndex(slots.empty() ? 16 : slots.size() * 2);
+    }
+
+    uint64_t hash = hashName(name);
+    size_t slot = probe(name, hash);
+    if (slots[slot].id != EMPTY_SLOT) return slots[slot].id;
+
+    uint32_t id = static_cast<uint32_t>(names.size());
+    names.emplace_back(name);
+    balances.emplace_back();
+    balanceKeys.push_back(0);
+    lastActivity.push_back(0);
+    hashes.push_back(hash);
+    slots[slot] = Slot{ id, static_cast<uint32_t>(hash >> 32) };
+    return id;
+}
+
+int64_t CounterpartyTable::sortKeyOf(const Amount& balance) {
+    if (balance.isFast()) return balance.rawUnits();
+
+    // Promoted: out of int64 range or with extra decimals. Truncate the
+    // decimal string to whole units and saturate, which keeps the order.
+    std::string text = balance.toString();
+    bool negative = !text.empty() && text[0] == '-';
+    const int64_t limit = std::numeric_limits<int64_t>::max();
+    int64_t units = 0;
+    int fracDigits = -1; // -1 until the decimal point
+    for (size_t i = negative ? 1 : 0; i < text.size() && fracDigits < KEY_DECIMALS; i++) {
+        if (text[i] == '.') {
+            fracDigits = 0;
+            continue;
+        }
+        if (units > (limit - 9) / 10) return negative ? std::numeric_limits<int64_t>::min() : limit;
+        units = units * 10 + (text[i] - '0');
+        if (fracDigits >= 0) fracDigits++;
+    }
+    for (fracDigits = std::max(fracDigits, 0); fracDigits < KEY_DECIMALS; fracDigits++) {
+        if (units > limit / 10) return negative ? std::numeric_limits<int64_t>::min() : limit;
+        units *= 10;
+    }
+    return negative ? -units : units;
+}
+
+uint64_t CounterpartyTable::magnitudeOf(int64_t key) {
+    return key < 0 ? 0ull - static_cast<uint64_t>(key) : static_cast<uint64_t>(key);
+}
+
+void CounterpartyTable::removeFromTotals(uint32_t id) {
+    const Amount& balance = balances[id];
+    if (balance.isNegative()) {
+        runningTotals.owedToYou += balance;
+        runningTotals.owingYouCount--;
+    } else if (!balance.isZero()) {
+        runningTotals.youOwe -= balance;
+        runningTotals.youOweCount--;
+    }
+}
+
+void CounterpartyTable::addToTotals(uint32_t id) {
+    const Amount& balance = balances[id];
+    if (balance.isNegative()) {
+        runningTotals.owedToYou -= balance;
+        runningTotals.owingYouCount++;
+    } else if (!balance.isZero()) {
+        runningTotals.youOwe += balance;
+        runningTotals.youOweCount++;
+    }
+
+    if (largestStale) return;
+    uint64_t magnitude = magnitudeOf(balanceKeys[id]);
+    if (largestId == NOT_FOUND || magnitude > magnitudeOf(balanceKeys[largestId])) {
+        if (magnitude > 0) largestId = id;
+    } else if (id == largestId) {
+        largestStale = true; // Shrank; something else may be larger now
+    }
+}
+
+void CounterpartyTable::setBalance(uint32_t id, const Amount& balance) {
+    removeFromTotals(id);
+    balances[id] = balance;
+    balanceKeys[id] = sortKeyOf(balance);
+    addToTotals(id);
+}
+
+void CounterpartyTable::addToBalance(uint32_t id, const Amount& amount) {
+    removeFromTotals(id);
+    balances[id] += amount;
+    balanceKeys[id] = sortKeyOf(balances[id]);
+    addToTotals(id);
+}
+
+uint32_t CounterpartyTable::largestExposure() const {
+    if (largestStale) {
+        largestId = NOT_FOUND;
+        uint64_t largest = 0;
+        for (uint32_t id = 0; id < balanceKeys.size(); id++) {
+            uint64_t magnitude = magnitudeOf(balanceKeys[id]);
+            if (magnitude > largest) {
+                largest = magnitude;
+                largestId = id;
+            }
+        }
+        largestStale = false;
+    }
+    return largestId;
+}
+
+int CounterpartyTable::compareBalances(uint32_t a, uint32_t b) const {
+    if (balanceKeys[a] != balanceKeys[b]) return balanceKeys[a] < balanceKeys[b] ? -1 : 1;
+    if (balances[a].isFast() && balances[b].isFast()) return 0;
+    return balances[a].compare(balances[b]);
+}
+
+void CounterpartyTable::touch(uint32_t id, int64_t timestamp) {
+    if (timestamp > lastActivity[id]) lastActivity[id] = timestamp;
+}
+
+void CounterpartyTable::clear() {
+    names.clear();
+    balances.clear();
+    balanceKeys.clear();
+    lastActivity.clear();
+    hashes.clear();
+    runningTotals = CounterpartyTotals();
+    largestId = NOT_FOUND;
+    largestStale = false;
+    slots.clear();
+}
+
+void CounterpartyTable::reserve(size_t count) {
+    names.reserve(count);
+    balances.reserve(count);
+    balanceKeys.reserve(count);
+    lastActivity.reserve(count);
+    hashes.reserve(count);
+
+    size_t slotCount = slots.empty() ? 16 : slots.size();
+    while (slotCount < count * 2) slotCount *= 2;
+    if (slotCount > slots.size()) {
+        rebuildIndex(slotCount);
+    }
+}
+
+void CounterpartyTable::rebuildIndex(size_t slotCount) {
+    slots.assign(slotCount, Slot{ EMPTY_SLOT, 0 });
+    size_t mask = slotCount - 1;
+    for (uint32_t id = 0; id < names.size(); id++) {
+        size_t slot = hashes[id] & mask;
+        while (slots[slot].id != EMPTY_SLOT) slot = (slot + 1) & mask;
+        slots[slot] = Slot{ id, static_cast<uint32_t>(hashes[id] >> 32) };
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "money.h"
+
+// Running totals over every balance, updated by delta on each balance change.
+// A negative balance means the counterparty owes you.
+struct CounterpartyTotals {
+    Amount owedToYou;        // Sum of negative balances, as a positive amount
+    Amount youOwe;           // Sum of positive balances
+    size_t owingYouCount = 0;
+    size_t youOweCount = 0;
+};
+
+// Borrowers/lenders keyed by dense ids. Ids are handed out in insertion order
+// (and double as ledger counterparty ids), names are found through an
+// open-addressing hash index, and balances live in one contiguous array
+// next to fixed-width sort keys so ordering never parses a balance.
+class CounterpartyTable {
+public:
+    static constexpr uint32_t NOT_FOUND = 0xFFFFFFFFu;
+
+    // Id for name, or NOT_FOUND
+    uint32_t find(std::string_view name) const;
+
+    // Id for name, adding it with a zero balance if it is new
+    uint32_t findOrAdd(std::string_view name);
+
+    size_t size() const { return names.size(); }
+    bool empty() const { return names.empty(); }
+    void clear();
+    void reserve(size_t count);
+
+    const std::string& nameOf(uint32_t id) const { return names[id]; }
+    const Amount& balanceOf(uint32_t id) const { return balances[id]; }
+    void setBalance(uint32_t id, const Amount& balance);
+    void addToBalance(uint32_t id, const Amount& amount);
+
+    // Balance in Amount units, saturated at the int64 limits and truncated
+    // towards zero; never decreases as the balance grows
+    int64_t balanceKey(uint32_t id) const { return balanceKeys[id]; }
+
+    // <0, 0 or >0 like Amount::compare, but through the sort keys; the exact
+    // values are only compared when the keys tie on out-of-range balances
+    int compareBalances(uint32_t a, uint32_t b) const;
+
+    const CounterpartyTotals& totals() const { return runningTotals; }
+
+    // Id with the largest absolute balance, NOT_FOUND when every balance is zero.
+    // Constant time except after the current largest shrank, which costs one
+    // scan over the sort keys.
+    uint32_t largestExposure() const;
+
+    // Newest ledger timestamp seen for id, 0 when there is none
+    int64_t lastActivityOf(uint32_t id) const { return lastActivity[id]; }
+    void touch(uint32_t id, int64_t timestamp);
+
+private:
+    static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+    // Index entry; the upper hash bits are kept inline so probing rarely touches names
+    struct Slot {
+        uint32_t id;
+        uint32_t tag;
+    };
+
+    std::vector<std::string> names;   // Indexed by id
+    std::vector<Amount> balances;     // Indexed by id
+    std::vector<int64_t> balanceKeys; // Indexed by id, kept in step with balances
+    std::vector<int64_t> lastActivity; // Indexed by id
+    std::vector<uint64_t> hashes;     // Indexed by id, so growing never rehashes strings
+    std::vector<Slot> slots;          // Power-of-two table, linear probing
+
+    CounterpartyTotals runningTotals;
+    mutable uint32_t largestId = NOT_FOUND;
+    mutable bool largestStale = false;  // The largest balance shrank; rescan on the next query
+
+    static uint64_t hashName(std::string_view name);
+    static int64_t sortKeyOf(const Amount& balance);
+    static uint64_t magnitudeOf(int64_t key);
+    void removeFromTotals(uint32_t id);
+    void addToTotals(uint32_t id);
+    size_t probe(std::string_view name, uint64_t hash) const;
+    void rebuildIndex(size_t slotCount);
+};
@@ -0,0 +1,114 @@
+#include "crc32c.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MONEYTRACKER_CRC_X86 1
+#include <nmmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CRC_TARGET
+#else
+#include <cpuid.h>
+#define CRC_TARGET __attribute__((target("sse4.2")))
+#endif
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define MONEYTRACKER_CRC_ARM 1
+#include <arm_acle.h>
+#endif
+
+namespace {
+    const uint32_t POLYNOMIAL = 0x82F63B78u; // Reflected Castagnoli polynomial
+
+    // table[k][b] is the CRC of byte b followed by k zero bytes
+    struct Tables {
+        uint32_t table[8][256];
+
+        Tables() {
+            for (uint32_t b = 0; b < 256; b++) {
+                uint32_t crc = b;
+                for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (POLYNOMIAL & (0u - (crc & 1)));
+                table[0][b] = crc;
+            }
+            for (uint32_t b = 0; b < 256; b++) {
+                for (int k = 1; k < 8; k++) table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xFF];
+            }
+        }
+    };
+
+    const Tables& tables() {
+        static const Tables instance;
+        return instance;
+    }
+
+    uint32_t softwareCrc(const uint8_t* p, size_t size, uint32_t crc) {
+        const auto& t = tables().table;
+        for (; size >= 8; size -= 8, p += 8) {
+            uint32_t low, high;
+            std::memcpy(&low, p, 4);
+            std::memcpy(&high, p + 4, 4);
+            low ^= crc; // Little-endian host assumed, as for the save format itself
+            crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+                  t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        }
+        for (; size > 0; size--, p++) crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xFF];
+        return crc;
+    }
+
+#ifdef MONEYTRACKER_CRC_X86
+    bool cpuSupported() {
+        unsigned int ecx = 0;
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        ecx = static_cast<unsigned int>(info[2]);
+#else
+        unsigned int eax, ebx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+#endif
+        return (ecx & (1u << 20)) != 0; // SSE4.2
+    }
+
+    CRC_TARGET
+    uint32_t hardwareCrc(const uint8_t* p, size_t size, uint32_t crc) {
+        uint64_t wide = crc;
+        for (; size >= 8; size -= 8, p += 8) {
+            uint64_t word;
+            std::memcpy(&word, p, 8);
+            wide = _mm_crc32_u64(wide, word);
+        }
+        crc = static_cast<uint32_t>(wide);
+        for (; size > 0; size--, p++) crc = _mm_crc32_u8(crc, *p);
+        return crc;
+    }
+#elif defined(MONEYTRACKER_CRC_ARM)
+    uint32_t hardwareCrc(const uint8_t* p, size_t size, uint32_t crc) {
+        for (; size >= 8; size -= 8, p += 8) {
+            uint64_t word;
+            std::memcpy(&word, p, 8);
+            crc = __crc32cd(crc, word);
+        }
+        for (; size > 0; size--, p++) crc = __crc32cb(crc, *p);
+        return crc;
+    }
+#endif
+}
+
+bool crc32cHardwareAvailable() {
+#if defined(MONEYTRACKER_CRC_X86)
+    static const bool supported = cpuSupported();
+    return supported;
+#elif defined(MONEYTRACKER_CRC_ARM)
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t crc32c(const void* data, size_t size, uint32_t crc, bool forceSoftware) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+#if defined(MONEYTRACKER_CRC_X86) || defined(MONEYTRACKER_CRC_ARM)
+    if (!forceSoftware && crc32cHardwareAvailable()) return ~hardwareCrc(p, size, crc);
+#endif
+    return ~softwareCrc(p, size, crc);
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32C (Castagnoli), the checksum on save container blocks.
+// Uses the SSE4.2 / ARMv8 CRC instructions when available, otherwise a
+// slicing-by-8 table implementation.
+
+// True when a hardware CRC-32C path is compiled in and supported by this CPU
+bool crc32cHardwareAvailable();
+
+// Checksum of size bytes. Pass a previous result as crc to continue a running
+// checksum over several buffers. forceSoftware disables the hardware path (used by benchmarks).
+uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0, bool forceSoftware = false);
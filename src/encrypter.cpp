@@ -1,99 +1,214 @@
-#define NOMINMAX
-#include <windows.h>
-#include <bcrypt.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
-#pragma comment(lib, "bcrypt.lib")
+#include "encrypter.h"
 
+// AES-256-CBC with an all-zero IV and no padding, byte-compatible with the
+// earlier Windows CNG implementation so existing saves still open.
 
-std::string encryptAesCng(const std::string& plaintext, const std::string& keyStr) {
-    BCRYPT_ALG_HANDLE hAlg = nullptr;
-    BCRYPT_KEY_HANDLE hKey = nullptr;
-    NTSTATUS status;
-    DWORD cbKeyObject = 0, cbData = 0, cbCipherText = 0;
-    PBYTE pbKeyObject = nullptr, pbCipherText = nullptr;
-
+void CryptoSession::setKey(const std::string& keyStr) {
     // Convert key to 256-bit (32 bytes)
-    BYTE key[32] = { 0 };
-    memcpy(key, keyStr.data(), std::min(keyStr.size(), sizeof(key)));
+    uint8_t raw[32] = { 0 };
+    memcpy(raw, keyStr.data(), std::min(keyStr.size(), sizeof(raw)));
+    aesExpandKey(raw, key);
+    std::fill(raw, raw + sizeof(raw), 0);
+    ready = true;
+}
 
-    BYTE iv[16] = { 0 }; // For CBC, IV must be 16 bytes
 
-    // Open AES provider
-    if (!BCRYPT_SUCCESS(status = BCryptOpenAlgorithmProvider(&hAlg, BCRYPT_AES_ALGORITHM, NULL, 0))) goto cleanup;
+void CryptoSession::clear() {
+    volatile uint8_t* bytes = reinterpret_cast<volatile uint8_t*>(&key);
+    for (size_t i = 0; i < sizeof(key); i++) bytes[i] = 0;
+    ready = false;
+}
 
-    // Set CBC mode
-    if (!BCRYPT_SUCCESS(status = BCryptSetProperty(hAlg, BCRYPT_CHAINING_MODE, (PUCHAR)BCRYPT_CHAIN_MODE_CBC, sizeof(BCRYPT_CHAIN_MODE_CBC), 0))) goto cleanup;
 
-    // Get key object size
-    if (!BCRYPT_SUCCESS(status = BCryptGetProperty(hAlg, BCRYPT_OBJECT_LENGTH, (PUCHAR)&cbKeyObject, sizeof(cbKeyObject), &cbData, 0))) goto cleanup;
-    pbKeyObject = (PUCHAR)HeapAlloc(GetProcessHeap(), 0, cbKeyObject);
-    if (!pbKeyObject) goto cleanup;
+bool CryptoSession::encrypt(const void* in, void* out, size_t size) const {
+    // CBC without padding only accepts whole blocks
+    if (!ready || size % 16 != 0) return false;
 
-    // Generate key
-    if (!BCRYPT_SUCCESS(status = BCryptGenerateSymmetricKey(hAlg, &hKey, pbKeyObject, cbKeyObject, key, sizeof(key), 0))) goto cleanup;
+    uint8_t iv[16] = { 0 }; // For CBC, IV must be 16 bytes
+    aesCbcEncrypt(key, iv, static_cast<const uint8_t*>(in), static_cast<uint8_t*>(out), size / 16);
+    return true;
+}
 
-    // Get ciphertext size
-    if (!BCRYPT_SUCCESS(status = BCryptEncrypt(hKey, (PUCHAR)plaintext.data(), (ULONG)plaintext.size(), nullptr, iv, sizeof(iv), nullptr, 0, &cbCipherText, 0))) goto cleanup;
-    pbCipherText = (PUCHAR)HeapAlloc(GetProcessHeap(), 0, cbCipherText);
-    if (!pbCipherText) goto cleanup;
 
-    // Encrypt
-    if (!BCRYPT_SUCCESS(status = BCryptEncrypt(hKey, (PUCHAR)plaintext.data(), (ULONG)plaintext.size(), nullptr, iv, sizeof(iv), pbCipherText, cbCipherText, &cbData, 0))) goto cleanup;
+bool CryptoSession::decrypt(const void* in, void* out, size_t size) const {
+    if (!ready || size % 16 != 0) return false;
 
-    // Return as std::string
-    return std::string((char*)pbCipherText, cbData);
+    uint8_t iv[16] = { 0 }; // Same IV used in encryption (all zeros here)
+    aesCbcDecrypt(key, iv, static_cast<const uint8_t*>(in), static_cast<uint8_t*>(out), size / 16);
+    return true;
+}
 
-cleanup:
-    if (hKey) BCryptDestroyKey(hKey);
-    if (hAlg) BCryptCloseAlgorithmProvider(hAlg, 0);
-    if (pbKeyObject) HeapFree(GetProcessHeap(), 0, pbKeyObject);
-    if (pbCipherText) HeapFree(GetProcessHeap(), 0, pbCipherText);
-    return ""; // Empty string on error
+
+bool CryptoSession::ctrXor(const uint8_t nonce[8], uint64_t firstBlock, const void* in, void* out, size_t size) const {
+    if (!ready) return false;
+
+    const uint8_t* src = static_cast<const uint8_t*>(in);
+    uint8_t* dst = static_cast<uint8_t*>(out);
+    const size_t BATCH = 32; // Counter blocks encrypted per call, keeps the AES-NI pipeline full
+    alignas(16) uint8_t counters[BATCH * 16];
+    alignas(16) uint8_t keystream[BATCH * 16];
+
+    uint64_t block = firstBlock;
+    while (size > 0) {
+        size_t blocks = std::min(BATCH, (size + 15) / 16);
+        for (size_t b = 0; b < blocks; b++, block++) {
+            uint8_t* counter = counters + 16 * b;
+            memcpy(counter, nonce, 8);
+            for (int i = 0; i < 8; i++) counter[8 + i] = static_cast<uint8_t>(block >> (56 - 8 * i));
+        }
+        aesEncryptBlocks(key, counters, keystream, blocks);
+
+        size_t bytes = std::min(size, blocks * 16);
+        size_t i = 0;
+        for (; i + 8 <= bytes; i += 8) {
+            uint64_t a, k;
+            memcpy(&a, src + i, 8);
+            memcpy(&k, keystream + i, 8);
+            a ^= k;
+            memcpy(dst + i, &a, 8);
+        }
+        for (; i < bytes; i++) dst[i] = src[i] ^ keystream[i];
+
+        src += bytes;
+        dst += bytes;
+        size -= bytes;
+    }
+    return true;
 }
 
 
-std::string decryptAesCng(const std::string& ciphertext, const std::string& keyStr) {
-    BCRYPT_ALG_HANDLE hAlg = nullptr;
-    BCRYPT_KEY_HANDLE hKey = nullptr;
-    NTSTATUS status;
-    DWORD cbKeyObject = 0, cbData = 0, cbPlainText = 0;
-    PBYTE pbKeyObject = nullptr, pbPlainText = nullptr;
+namespace {
+    const char CHUNKED_MAGIC[8] = { 'M', 'T', 'C', 'H', 'U', 'N', 'K', '1' };
+    const uint32_t CHUNK_SIZE = 1u << 20; // 1 MiB, a multiple of the AES block size
+
+    struct ChunkedHeader {
+        char magic[8];
+        uint32_t chunkSize;
+        uint32_t reserved;
+        uint8_t nonce[8];     // Fresh per save so the keystream is never reused
+        uint64_t plainSize;
+        uint8_t keyCheck[16]; // E(nonce || 0xFF..FF), lets login reject a wrong key without a bulk decrypt
+    };
+
+    static_assert(sizeof(ChunkedHeader) == 48, "ChunkedHeader layout changed");
+
+    // The last counter block of the nonce is never reached by data (2^64 blocks)
+    const uint64_t KEY_CHECK_BLOCK = ~0ull;
+
+    void computeKeyCheck(const CryptoSession& crypto, const uint8_t nonce[8], uint8_t out[16]) {
+        uint8_t zero[16] = { 0 };
+        crypto.ctrXor(nonce, KEY_CHECK_BLOCK, zero, out, sizeof(zero));
+    }
+
+    bool keyCheckMatches(const CryptoSession& crypto, const ChunkedHeader& header) {
+        if (!crypto.isReady()) return false;
+        uint8_t expected[16];
+        computeKeyCheck(crypto, header.nonce, expected);
+        uint8_t diff = 0; // Constant-time compare
+        for (int i = 0; i < 16; i++) diff |= expected[i] ^ header.keyCheck[i];
+        return diff == 0;
+    }
+
+    // Run every chunk through CTR, spreading chunks across worker threads
+    bool processChunks(const CryptoSession& crypto, const ChunkedHeader& header,
+                       const uint8_t* in, uint8_t* out, unsigned threads,
+                       std::atomic<uint64_t>* bytesDone = nullptr, const std::atomic<bool>* cancel = nullptr) {
+        size_t chunkCount = (header.plainSize + header.chunkSize - 1) / header.chunkSize;
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::min<size_t>(threads, chunkCount));
+
+        std::atomic<size_t> nextChunk{ 0 };
+        std::atomic<bool> ok{ true };
+        auto worker = [&]() {
+            for (size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+                if (cancel && *cancel) {
+                    ok = false;
+                    return;
+                }
+                uint64_t offset = static_cast<uint64_t>(chunk) * header.chunkSize;
+                size_t length = static_cast<size_t>(std::min<uint64_t>(header.chunkSize, header.plainSize - offset));
+                if (!crypto.ctrXor(header.nonce, offset / 16, in + offset, out + offset, length)) ok = false;
+                if (bytesDone) *bytesDone += length;
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+        worker();
+        for (std::thread& thread : pool) thread.join();
+        return ok;
+    }
+}
+
+
+bool isChunkedContainer(std::string_view data) {
+    return data.size() >= sizeof(ChunkedHeader) && memcmp(data.data(), CHUNKED_MAGIC, sizeof(CHUNKED_MAGIC)) == 0;
+}
 
-    // Convert key to 256-bit (32 bytes)
-    BYTE key[32] = { 0 };
-    memcpy(key, keyStr.data(), std::min(keyStr.size(), sizeof(key)));
 
-    BYTE iv[16] = { 0 }; // Same IV used in encryption (all zeros here)
+std::string encryptChunked(const std::string& plaintext, const CryptoSession& crypto, unsigned threads) {
+    if (!crypto.isReady()) return "";
+
+    ChunkedHeader header{};
+    memcpy(header.magic, CHUNKED_MAGIC, sizeof(CHUNKED_MAGIC));
+    header.chunkSize = CHUNK_SIZE;
+    header.plainSize = plaintext.size();
+    std::random_device random;
+    for (int i = 0; i < 8; i += 4) {
+        uint32_t value = random();
+        memcpy(header.nonce + i, &value, 4);
+    }
+    computeKeyCheck(crypto, header.nonce, header.keyCheck);
+
+    std::string result(sizeof(header) + plaintext.size(), '\0');
+    memcpy(&result[0], &header, sizeof(header));
+    uint8_t* out = reinterpret_cast<uint8_t*>(&result[sizeof(header)]);
+    if (!processChunks(crypto, header, reinterpret_cast<const uint8_t*>(plaintext.data()), out, threads)) return "";
+    return result;
+}
 
-    // Open AES algorithm provider
-    if (!BCRYPT_SUCCESS(status = BCryptOpenAlgorithmProvider(&hAlg, BCRYPT_AES_ALGORITHM, NULL, 0))) goto cleanup;
 
-    // Set chaining mode to CBC
-    if (!BCRYPT_SUCCESS(status = BCryptSetProperty(hAlg, BCRYPT_CHAINING_MODE, (PUCHAR)BCRYPT_CHAIN_MODE_CBC, sizeof(BCRYPT_CHAIN_MODE_CBC), 0))) goto cleanup;
+bool chunkedKeyMatches(std::string_view container, const CryptoSession& crypto) {
+    if (!isChunkedContainer(container)) return false;
+    ChunkedHeader header;
+    memcpy(&header, container.data(), sizeof(header));
+    return keyCheckMatches(crypto, header);
+}
 
-    // Get size for key object
-    if (!BCRYPT_SUCCESS(status = BCryptGetProperty(hAlg, BCRYPT_OBJECT_LENGTH, (PUCHAR)&cbKeyObject, sizeof(cbKeyObject), &cbData, 0))) goto cleanup;
-    pbKeyObject = (PUCHAR)HeapAlloc(GetProcessHeap(), 0, cbKeyObject);
-    if (!pbKeyObject) goto cleanup;
 
-    // Generate key
-    if (!BCRYPT_SUCCESS(status = BCryptGenerateSymmetricKey(hAlg, &hKey, pbKeyObject, cbKeyObject, key, sizeof(key), 0))) goto cleanup;
+bool decryptChunked(std::string_view container, const CryptoSession& crypto, std::string& out, unsigned threads,
+                    std::atomic<uint64_t>* bytesDone, const std::atomic<bool>* cancel) {
+    if (!isChunkedContainer(container)) return false;
 
-    // Get required size for plaintext
-    if (!BCRYPT_SUCCESS(status = BCryptDecrypt(hKey, (PUCHAR)ciphertext.data(), (ULONG)ciphertext.size(), nullptr, iv, sizeof(iv), nullptr, 0, &cbPlainText, 0))) goto cleanup;
-    pbPlainText = (PUCHAR)HeapAlloc(GetProcessHeap(), 0, cbPlainText);
-    if (!pbPlainText) goto cleanup;
+    ChunkedHeader header;
+    memcpy(&header, container.data(), sizeof(header));
+    if (!keyCheckMatches(crypto, header)) return false;
+    if (header.chunkSize == 0 || header.chunkSize % 16 != 0) return false;
+    if (header.plainSize != container.size() - sizeof(header)) return false;
 
-    // Perform decryption
-    if (!BCRYPT_SUCCESS(status = BCryptDecrypt(hKey, (PUCHAR)ciphertext.data(), (ULONG)ciphertext.size(), nullptr, iv, sizeof(iv), pbPlainText, cbPlainText, &cbData, 0))) goto cleanup;
+    out.resize(header.plainSize);
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(container.data() + sizeof(header));
+    return processChunks(crypto, header, in, reinterpret_cast<uint8_t*>(&out[0]), threads, bytesDone, cancel);
+}
 
-    return std::string((char*)pbPlainText, cbData);
 
-cleanup:
-    if (hKey) BCryptDestroyKey(hKey);
-    if (hAlg) BCryptCloseAlgorithmProvider(hAlg, 0);
-    if (pbKeyObject) HeapFree(GetProcessHeap(), 0, pbKeyObject);
-    if (pbPlainText) HeapFree(GetProcessHeap(), 0, pbPlainText);
-    return ""; // Empty string on failure
-}
\ No newline at end of file
+std::string encryptAesCng(const std::string& plaintext, const std::string& keyStr) {
+    std::string result = plaintext;
+    if (!CryptoSession(keyStr).encryptInPlace(result)) return ""; // Empty string on error
+    return result;
+}
+
+
+std::string decryptAesCng(const std::string& ciphertext, const std::string& keyStr) {
+    std::string result = ciphertext;
+    if (!CryptoSession(keyStr).decryptInPlace(result)) return ""; // Empty string on failure
+    return result;
+}
@@ -1,6 +1,54 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+
+#include "aes.h"
+
+// AES-256-CBC with an all-zero IV and no padding.
+// A session expands the key once (at login) and then encrypts/decrypts caller
+// buffers without further allocation. Sizes must be a multiple of 16.
+class CryptoSession {
+public:
+    CryptoSession() = default;
+    explicit CryptoSession(const std::string& keyStr) { setKey(keyStr); }
+
+    // Expand a password key (zero-padded/truncated to 32 bytes)
+    void setKey(const std::string& keyStr);
+    // Forget the key schedule (logout/reset)
+    void clear();
+    bool isReady() const { return ready; }
+
+    // in and out may be the same buffer. Returns false on a partial block or no key.
+    bool encrypt(const void* in, void* out, size_t size) const;
+    bool decrypt(const void* in, void* out, size_t size) const;
+
+    bool encryptInPlace(std::string& buffer) const { return encrypt(buffer.data(), &buffer[0], buffer.size()); }
+    bool decryptInPlace(std::string& buffer) const { return decrypt(buffer.data(), &buffer[0], buffer.size()); }
+
+    // CTR keystream XOR (encrypt and decrypt are the same operation). The counter
+    // block is nonce || big-endian block index, starting at firstBlock, so any
+    // block-aligned range can be processed independently. Any size is accepted.
+    bool ctrXor(const uint8_t nonce[8], uint64_t firstBlock, const void* in, void* out, size_t size) const;
+
+private:
+    AesKey key{};
+    bool ready = false;
+};
+
+// Chunked CTR container for save files. Chunks are independent, so they are
+// encrypted/decrypted on all cores. Layout: [48-byte header][ciphertext], no padding.
+// The header carries a salted key-check block, so a wrong key is rejected before
+// any bulk work. threads = 0 uses every hardware thread.
+bool isChunkedContainer(std::string_view data);
+bool chunkedKeyMatches(std::string_view container, const CryptoSession& crypto);
+std::string encryptChunked(const std::string& plaintext, const CryptoSession& crypto, unsigned threads = 0);
+// bytesDone, when given, grows as chunks finish; setting cancel stops the remaining chunks and fails the call
+bool decryptChunked(std::string_view container, const CryptoSession& crypto, std::string& out, unsigned threads = 0,
+                    std::atomic<uint64_t>* bytesDone = nullptr, const std::atomic<bool>* cancel = nullptr);
 
 std::string encryptAesCng(const std::string& plaintext, const std::string& keyStr);
 
-std::string decryptAesCng(const std::string& ciphertext, const std::string& keyStr);
\ No newline at end of file
+std::string decryptAesCng(const std::string& ciphertext, const std::string& keyStr);
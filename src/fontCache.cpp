@@ -0,0 +1,162 @@
+#include "fontCache.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+#include "savingFunctions.h"
+
+const ImWchar FONT_GLYPH_RANGES[] = {
+    0x0020, 0x00FF, // Basic Latin + Latin-1 Supplement
+    0,
+};
+
+// The atlas is stored as ImGui's own structures, so a cache written by a
+// different ImGui version or glyph layout is never trusted.
+namespace {
+    const char CACHE_MAGIC[8] = { 'M', 'T', 'F', 'O', 'N', 'T', '1', '\0' };
+    const uint32_t LINE_COUNT = IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1; // Entries in ImFontAtlas::TexUvLines
+
+    struct CacheHeader {
+        char magic[8];
+        uint32_t imguiVersion;
+        uint32_t glyphBytes;   // sizeof(ImFontGlyph)
+        uint64_t fontBytes;    // Size and write time of the TTF the atlas was baked from
+        int64_t fontTime;
+        float sizePixels;
+        uint32_t rangesHash;
+        uint32_t pathLength;   // Font path follows the header
+        uint32_t glyphCount;
+        int32_t texWidth;
+        int32_t texHeight;
+        float fontSize;
+        float ascent;
+        float descent;
+        float uvScale[2];
+        float uvWhite[2];
+    };
+
+    uint32_t hashRanges(const ImWchar* ranges) {
+        uint32_t hash = 2166136261u; // FNV-1a
+        for (; *ranges != 0; ranges++) {
+            hash = (hash ^ static_cast<uint32_t>(*ranges)) * 16777619u;
+        }
+        return hash;
+    }
+
+    // Key fields shared by load and save; false when the font file cannot be stat'ed
+    bool fillKey(CacheHeader& header, const std::string& fontPath, float sizePixels) {
+        std::error_code ec;
+        uint64_t bytes = std::filesystem::file_size(fontPath, ec);
+        if (ec) return false;
+        auto time = std::filesystem::last_write_time(fontPath, ec);
+        if (ec) return false;
+
+        memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        header.imguiVersion = IMGUI_VERSION_NUM;
+        header.glyphBytes = sizeof(ImFontGlyph);
+        header.fontBytes = bytes;
+        header.fontTime = static_cast<int64_t>(time.time_since_epoch().count());
+        header.sizePixels = sizePixels;
+        header.rangesHash = hashRanges(FONT_GLYPH_RANGES);
+        header.pathLength = static_cast<uint32_t>(fontPath.size());
+        return true;
+    }
+
+    bool sameKey(const CacheHeader& a, const CacheHeader& b) {
+        return memcmp(a.magic, b.magic, sizeof(a.magic)) == 0 && a.imguiVersion == b.imguiVersion &&
+               a.glyphBytes == b.glyphBytes && a.fontBytes == b.fontBytes && a.fontTime == b.fontTime &&
+               a.sizePixels == b.sizePixels && a.rangesHash == b.rangesHash && a.pathLength == b.pathLength;
+    }
+}
+
+
+bool loadFontAtlasCache(ImFontAtlas* atlas, const std::string& cachePath, const std::string& fontPath, float sizePixels) {
+    atlas->Clear();
+
+    CacheHeader expected{};
+    if (!fillKey(expected, fontPath, sizePixels)) return false;
+
+    bool readErr = false;
+    std::string cache = loadFile(cachePath, readErr);
+    if (readErr || cache.size() < sizeof(CacheHeader)) return false;
+
+    CacheHeader header;
+    memcpy(&header, cache.data(), sizeof(header));
+    if (!sameKey(header, expected)) return false;
+    if (header.texWidth <= 0 || header.texHeight <= 0 || header.glyphCount == 0) return false;
+
+    size_t pixelBytes = static_cast<size_t>(header.texWidth) * static_cast<size_t>(header.texHeight);
+    size_t glyphBytes = static_cast<size_t>(header.glyphCount) * sizeof(ImFontGlyph);
+    size_t lineBytes = LINE_COUNT * sizeof(ImVec4);
+    if (cache.size() != sizeof(header) + header.pathLength + lineBytes + glyphBytes + pixelBytes) return false;
+
+    const char* cursor = cache.data() + sizeof(header);
+    if (fontPath.compare(0, std::string::npos, cursor, header.pathLength) != 0) return false;
+    cursor += header.pathLength;
+
+    // Rebuild the one font the way ImFontAtlas::Build() leaves it, minus the rasterising
+    ImFontConfig config;
+    config.SizePixels = sizePixels;
+    config.GlyphRanges = FONT_GLYPH_RANGES;
+    config.FontDataOwnedByAtlas = false;
+    atlas->ConfigData.push_back(config);
+    ImFontConfig& stored = atlas->ConfigData.back();
+
+    ImFont* font = IM_NEW(ImFont);
+    atlas->Fonts.push_back(font);
+    stored.DstFont = font;
+    font->ContainerAtlas = atlas;
+    font->ConfigData = &stored;
+    font->ConfigDataCount = 1;
+    font->FontSize = header.fontSize;
+    font->Ascent = header.ascent;
+    font->Descent = header.descent;
+
+    memcpy(atlas->TexUvLines, cursor, lineBytes);
+    cursor += lineBytes;
+    font->Glyphs.resize(static_cast<int>(header.glyphCount));
+    memcpy(font->Glyphs.Data, cursor, glyphBytes);
+    cursor += glyphBytes;
+    font->BuildLookupTable();
+
+    atlas->TexWidth = header.texWidth;
+    atlas->TexHeight = header.texHeight;
+    atlas->TexUvScale = ImVec2(header.uvScale[0], header.uvScale[1]);
+    atlas->TexUvWhitePixel = ImVec2(header.uvWhite[0], header.uvWhite[1]);
+    atlas->TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(pixelBytes));
+    memcpy(atlas->TexPixelsAlpha8, cursor, pixelBytes);
+    atlas->TexReady = true;
+    return true;
+}
+
+
+bool saveFontAtlasCache(ImFontAtlas* atlas, const std::string& cachePath, const std::string& fontPath, float sizePixels) {
+    CacheHeader header{};
+    if (!fillKey(header, fontPath, sizePixels)) return false;
+    if (atlas->Fonts.Size != 1) return false;
+
+    unsigned char* pixels = nullptr;
+    int width = 0, height = 0;
+    atlas->GetTexDataAsAlpha8(&pixels, &width, &height); // Builds the atlas if needed
+    if (pixels == nullptr) return false;
+
+    const ImFont* font = atlas->Fonts[0];
+    header.glyphCount = static_cast<uint32_t>(font->Glyphs.Size);
+    header.texWidth = width;
+    header.texHeight = height;
+    header.fontSize = font->FontSize;
+    header.ascent = font->Ascent;
+    header.descent = font->Descent;
+    header.uvScale[0] = atlas->TexUvScale.x;
+    header.uvScale[1] = atlas->TexUvScale.y;
+    header.uvWhite[0] = atlas->TexUvWhitePixel.x;
+    header.uvWhite[1] = atlas->TexUvWhitePixel.y;
+
+    std::string cache(reinterpret_cast<const char*>(&header), sizeof(header));
+    cache += fontPath;
+    cache.append(reinterpret_cast<const char*>(atlas->TexUvLines), LINE_COUNT * sizeof(ImVec4));
+    cache.append(reinterpret_cast<const char*>(font->Glyphs.Data), font->Glyphs.Size * sizeof(ImFontGlyph));
+    cache.append(reinterpret_cast<const char*>(pixels), static_cast<size_t>(width) * static_cast<size_t>(height));
+    return !saveToFile(cache, cachePath); // saveToFile returns true on error
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+
+#include "imgui.h"
+
+// Glyphs baked into the atlas: printable ASCII and Latin-1, which covers the
+// UI strings and most borrower names. Keeping the set small keeps the bake fast.
+extern const ImWchar FONT_GLYPH_RANGES[];
+
+// Restore a previously baked atlas for fontPath at sizePixels. False when the
+// cache is missing, stale (font file, size, ranges or ImGui version changed)
+// or unreadable; the atlas is left cleared in that case.
+bool loadFontAtlasCache(ImFontAtlas* atlas, const std::string& cachePath, const std::string& fontPath, float sizePixels);
+
+// Bake the atlas now and write it to cachePath. Expects exactly the one font
+// added from fontPath at sizePixels with FONT_GLYPH_RANGES.
+bool saveFontAtlasCache(ImFontAtlas* atlas, const std::string& cachePath, const std::string& fontPath, float sizePixels);
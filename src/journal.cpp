@@ -0,0 +1,194 @@
+#include "journal.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+#include "encrypter.h"
+#include "savingFunctions.h"
+
+namespace {
+    const char RECORD_MAGIC[4] = { 'M', 'T', 'J', 'R' };
+
+    // Plaintext record header. The sequence number makes the first CBC block
+    // unique per record, so identical mutations never encrypt identically.
+    struct RecordHeader {
+        char magic[4];
+        uint32_t payloadSize;
+        uint64_t sequence;
+    };
+
+    static_assert(sizeof(RecordHeader) == 16, "RecordHeader must fill one AES block");
+
+    struct FrameHeader {
+        uint64_t sequence;
+        uint32_t cipherSize;
+    };
+
+    const size_t FRAME_HEADER_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+
+    template <typename T>
+    void putInt(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void putString(std::string& out, const std::string& value) {
+        putInt<uint32_t>(out, static_cast<uint32_t>(value.size()));
+        out.append(value);
+    }
+
+    bool getString(std::string_view& in, std::string& value) {
+        uint32_t length;
+        if (in.size() < sizeof(length)) return false;
+        std::memcpy(&length, in.data(), sizeof(length));
+        in.remove_prefix(sizeof(length));
+        if (in.size() < length) return false;
+        value.assign(in.data(), length);
+        in.remove_prefix(length);
+        return true;
+    }
+
+    // Append the plaintext record for a mutation to out, padded to whole blocks
+    void encodeRecord(const Mutation& mutation, uint64_t sequence, std::string& out) {
+        std::string payload;
+        payload.push_back(static_cast<char>(mutation.type));
+        putInt<int64_t>(payload, mutation.timestamp);
+        putString(payload, mutation.name);
+        putString(payload, mutation.value);
+
+        RecordHeader header;
+        std::memcpy(header.magic, RECORD_MAGIC, sizeof(RECORD_MAGIC));
+        header.payloadSize = static_cast<uint32_t>(payload.size());
+        header.sequence = sequence;
+
+        out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        out += payload;
+        // CBC without padding needs whole blocks
+        out.append((16 - payload.size() % 16) % 16, '\0');
+    }
+
+    bool decodeRecord(std::string_view record, uint64_t sequence, Mutation& out) {
+        RecordHeader header;
+        if (record.size() < sizeof(header)) return false;
+        std::memcpy(&header, record.data(), sizeof(header));
+        if (std::memcmp(header.magic, RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0 || header.sequence != sequence) return false;
+        if (header.payloadSize > record.size() - sizeof(header)) return false;
+
+        std::string_view payload(record.data() + sizeof(header), header.payloadSize);
+        if (payload.size() < 1 + sizeof(int64_t)) return false;
+        out.type = static_cast<MutationType>(payload[0]);
+        std::memcpy(&out.timestamp, payload.data() + 1, sizeof(int64_t));
+        payload.remove_prefix(1 + sizeof(int64_t));
+        return getString(payload, out.name) && getString(payload, out.value);
+    }
+
+    bool readFrame(std::string_view& data, FrameHeader& frame, std::string_view& cipher) {
+        if (data.size() < FRAME_HEADER_SIZE) return false;
+        std::memcpy(&frame.sequence, data.data(), sizeof(frame.sequence));
+        std::memcpy(&frame.cipherSize, data.data() + sizeof(frame.sequence), sizeof(frame.cipherSize));
+        if (data.size() - FRAME_HEADER_SIZE < frame.cipherSize) return false;
+        cipher = data.substr(FRAME_HEADER_SIZE, frame.cipherSize);
+        data.remove_prefix(FRAME_HEADER_SIZE + frame.cipherSize);
+        return true;
+    }
+}
+
+bool Journal::append(const std::vector<Mutation>& mutations, const CryptoSession& crypto) {
+    if (mutations.empty()) return true;
+
+    // Records are encoded straight into the frame buffer and encrypted in place
+    std::string frames;
+    uint64_t sequence = lastSequence;
+    for (const Mutation& mutation : mutations) {
+        sequence++;
+        putInt<uint64_t>(frames, sequence);
+        size_t sizeOffset = frames.size();
+        putInt<uint32_t>(frames, 0);
+
+        size_t recordOffset = frames.size();
+        encodeRecord(mutation, sequence, frames);
+        uint32_t cipherSize = static_cast<uint32_t>(frames.size() - recordOffset);
+        std::memcpy(&frames[sizeOffset], &cipherSize, sizeof(cipherSize));
+        if (!crypto.encrypt(frames.data() + recordOffset, &frames[recordOffset], cipherSize)) return false;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (!file.is_open()) return false;
+    file.write(frames.data(), frames.size());
+    file.close();
+    if (!file) return false;
+
+    lastSequence = sequence;
+    return true;
+}
+
+bool Journal::read(const CryptoSession& crypto, uint64_t afterSequence, std::vector<Mutation>& out) {
+    lastSequence = afterSequence;
+
+    bool readErr = false;
+    std::string contents = loadFile(path, readErr);
+    if (readErr) return true; // No journal yet
+
+    std::string_view data = contents;
+    FrameHeader frame;
+    std::string_view cipher;
+    std::string record;
+    while (readFrame(data, frame, cipher)) {
+        if (frame.sequence > afterSequence) {
+            // A complete frame that does not read is damage, not an interrupted
+            // append; later frames may hold saved changes, so the file stays as is
+            record.resize(cipher.size());
+            Mutation mutation;
+            if (!crypto.decrypt(cipher.data(), &record[0], cipher.size()) ||
+                !decodeRecord(record, frame.sequence, mutation)) return false;
+            out.push_back(std::move(mutation));
+            lastSequence = frame.sequence;
+        }
+    }
+
+    // Cut off a frame torn by an interrupted append, otherwise the next append
+    // lands behind it and is swallowed by the broken frame on the following login
+    if (!data.empty()) {
+        size_t goodEnd = contents.size() - data.size();
+        std::error_code ec;
+        std::filesystem::resize_file(path, goodEnd, ec);
+        if (ec) return false;
+    }
+    return true;
+}
+
+bool Journal::dropThrough(uint64_t sequence) {
+    bool readErr = false;
+    std::string contents = loadFile(path, readErr);
+    if (readErr) return true;
+
+    std::string kept;
+    std::string_view data = contents;
+    std::string_view frameStart = data;
+    FrameHeader frame;
+    std::string_view cipher;
+    while (readFrame(data, frame, cipher)) {
+        if (frame.sequence > sequence) {
+            kept.append(frameStart.data(), frameStart.size() - data.size());
+        }
+        frameStart = data;
+    }
+
+    std::string tempPath = path + ".tmp";
+    if (saveToFile(kept, tempPath)) return false;
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    return !ec;
+}
+
+void Journal::remove() {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    lastSequence = 0;
+}
+
+uint64_t Journal::getSizeBytes() const {
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<uint64_t>(size);
+}
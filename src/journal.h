@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "encrypter.h"
+
+// A single user-visible change, replayed on top of the base snapshot at login
+enum class MutationType : uint8_t {
+    TRANSACTION = 1,   // value = signed amount
+    BORROWER = 2,      // name = counterparty, value = signed amount
+    NOTE = 3           // value = note text
+};
+
+struct Mutation {
+    MutationType type;
+    int64_t timestamp;
+    std::string name;
+    std::string value;
+};
+
+// Append-only encrypted journal of mutations stored next to the base snapshot.
+// Each frame is [uint64 sequence][uint32 length][ciphertext]; the sequence stays in
+// clear so compaction can drop covered frames without the key.
+class Journal {
+public:
+    explicit Journal(std::string path) : path(std::move(path)) {}
+
+    // Encrypt and append mutations; cost is proportional to the mutations only
+    bool append(const std::vector<Mutation>& mutations, const CryptoSession& crypto);
+
+    // Decrypt every frame with a sequence number above afterSequence, in order.
+    // A frame cut short by an interrupted append is truncated away. Returns false,
+    // leaving the file untouched, when a complete frame does not decrypt or decode
+    // (out then holds the frames before it) or the truncation fails.
+    bool read(const CryptoSession& crypto, uint64_t afterSequence, std::vector<Mutation>& out);
+
+    // Rewrite the journal keeping only frames newer than sequence (after a snapshot covered them)
+    bool dropThrough(uint64_t sequence);
+
+    // Delete the journal file
+    void remove();
+
+    const std::string& getPath() const { return path; }
+    uint64_t getLastSequence() const { return lastSequence; }
+    void setLastSequence(uint64_t sequence) { lastSequence = sequence; }
+    uint64_t getSizeBytes() const;
+
+private:
+    std::string path;
+    uint64_t lastSequence = 0;
+};
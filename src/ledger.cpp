@@ -0,0 +1,183 @@
+#include "ledger.h"
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+namespace {
+    const char LEDGER_MAGIC[8] = { 'M', 'T', 'L', 'E', 'D', 'G', 'R', '1' };
+
+    // Written after the entries, text pool and balance strings
+    struct LedgerFooter {
+        uint64_t entryCount;
+        uint64_t poolSize;
+        uint32_t openingLength;
+        uint32_t balanceLength;
+        char magic[8];
+    };
+
+    static_assert(sizeof(LedgerFooter) == 32, "LedgerFooter must stay 32 bytes");
+}
+
+int64_t Ledger::currentTimestamp() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+int32_t Ledger::yearOf(int64_t timestamp) {
+    // Civil-from-days (Howard Hinnant), no gmtime so it is thread-safe everywhere
+    int64_t days = timestamp / 86400 - (timestamp % 86400 < 0 ? 1 : 0);
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t dayOfEra = days - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t monthIndex = (5 * dayOfYear + 2) / 153; // March-based month
+    return static_cast<int32_t>(yearOfEra + era * 400 + (monthIndex >= 10 ? 1 : 0));
+}
+
+void Ledger::reset(const Amount& opening) {
+    entries.clear();
+    textPool.clear();
+    openingBalance = opening;
+    balance = opening;
+}
+
+uint32_t Ledger::storeText(std::string_view text) {
+    uint32_t offset = static_cast<uint32_t>(textPool.size());
+    uint32_t length = static_cast<uint32_t>(text.size());
+    textPool.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    textPool.append(text.data(), text.size());
+    return offset;
+}
+
+std::string_view Ledger::textAt(uint64_t offset) const {
+    if (offset + sizeof(uint32_t) > textPool.size()) return {};
+    uint32_t length;
+    std::memcpy(&length, textPool.data() + offset, sizeof(length));
+    if (offset + sizeof(length) + length > textPool.size()) return {};
+    return std::string_view(textPool.data() + offset + sizeof(length), length);
+}
+
+void Ledger::append(const Amount& signedAmount, uint32_t counterparty, std::string_view memo, int64_t timestamp) {
+    LedgerEntry entry = {};
+    entry.timestamp = timestamp;
+    entry.counterparty = counterparty;
+    entry.memo = memo.empty() ? NO_MEMO : storeText(memo);
+    entry.direction = signedAmount.isNegative() ? EntryDirection::MONEY_OUT : EntryDirection::MONEY_IN;
+
+    Amount magnitude = signedAmount.isNegative() ? -signedAmount : signedAmount;
+    if (magnitude.isFast()) {
+        entry.amount = magnitude.rawUnits();
+    } else {
+        // Rare: amounts beyond int64 cents are kept as text
+        entry.flags |= ENTRY_BIG_AMOUNT;
+        entry.amount = storeText(magnitude.toString());
+    }
+
+    entries.push_back(entry);
+    balance += signedAmount;
+}
+
+Amount Ledger::amountOf(const LedgerEntry& entry) const {
+    Amount magnitude = (entry.flags & ENTRY_BIG_AMOUNT)
+        ? Amount(std::string(textAt(static_cast<uint64_t>(entry.amount))))
+        : Amount::fromUnits(entry.amount);
+    return entry.direction == EntryDirection::MONEY_OUT ? -magnitude : magnitude;
+}
+
+std::string_view Ledger::memoOf(const LedgerEntry& entry) const {
+    if (entry.memo == NO_MEMO) return {};
+    return textAt(entry.memo);
+}
+
+void Ledger::appendTo(std::string& out) const {
+    std::string opening = openingBalance.toString();
+    std::string current = balance.toString();
+
+    LedgerFooter footer;
+    footer.entryCount = entries.size();
+    footer.poolSize = textPool.size();
+    footer.openingLength = static_cast<uint32_t>(opening.size());
+    footer.balanceLength = static_cast<uint32_t>(current.size());
+    std::memcpy(footer.magic, LEDGER_MAGIC, sizeof(LEDGER_MAGIC));
+
+    size_t entryBytes = entries.size() * sizeof(LedgerEntry);
+    out.reserve(out.size() + entryBytes + textPool.size() + opening.size() + current.size() + sizeof(footer));
+    out.append(reinterpret_cast<const char*>(entries.data()), entryBytes);
+    out.append(textPool);
+    out.append(opening);
+    out.append(current);
+    out.append(reinterpret_cast<const char*>(&footer), sizeof(footer));
+}
+
+size_t Ledger::loadFrom(std::string_view data) {
+    LedgerFooter footer;
+    if (data.size() < sizeof(footer)) {
+        reset(Amount());
+        return data.size();
+    }
+    std::memcpy(&footer, data.data() + data.size() - sizeof(footer), sizeof(footer));
+    if (std::memcmp(footer.magic, LEDGER_MAGIC, sizeof(LEDGER_MAGIC)) != 0) {
+        reset(Amount());
+        return data.size();
+    }
+
+    uint64_t available = data.size() - sizeof(footer);
+    uint64_t stringBytes = uint64_t(footer.openingLength) + footer.balanceLength;
+    if (footer.entryCount > available / sizeof(LedgerEntry) ||
+        footer.poolSize > available - footer.entryCount * sizeof(LedgerEntry) ||
+        stringBytes > available - footer.entryCount * sizeof(LedgerEntry) - footer.poolSize) {
+        reset(Amount());
+        return data.size();
+    }
+
+    size_t blockSize = static_cast<size_t>(footer.entryCount * sizeof(LedgerEntry) + footer.poolSize + stringBytes);
+    const char* cursor = data.data() + available - blockSize;
+
+    entries.resize(static_cast<size_t>(footer.entryCount));
+    std::memcpy(entries.data(), cursor, entries.size() * sizeof(LedgerEntry));
+    cursor += entries.size() * sizeof(LedgerEntry);
+
+    textPool.assign(cursor, static_cast<size_t>(footer.poolSize));
+    cursor += footer.poolSize;
+
+    openingBalance = Amount(std::string(cursor, footer.openingLength));
+    cursor += footer.openingLength;
+    balance = Amount(std::string(cursor, footer.balanceLength));
+
+    return static_cast<size_t>(available - blockSize);
+}
+
+Ledger Ledger::slice(size_t first, size_t last, const Amount& opening) const {
+    Ledger out;
+    out.reset(opening);
+    out.entries.reserve(last - first);
+    for (size_t i = first; i < last; i++) {
+        LedgerEntry entry = entries[i];
+        if (entry.memo != NO_MEMO) entry.memo = out.storeText(memoOf(entries[i]));
+        if (entry.flags & ENTRY_BIG_AMOUNT) entry.amount = out.storeText(textAt(static_cast<uint64_t>(entries[i].amount)));
+        out.entries.push_back(entry);
+        out.balance += amountOf(entries[i]);
+    }
+    return out;
+}
+
+void Ledger::restore(std::vector<LedgerEntry> loadedEntries, std::string loadedTextPool, const Amount& opening, const Amount& current) {
+    entries = std::move(loadedEntries);
+    textPool = std::move(loadedTextPool);
+    openingBalance = opening;
+    balance = current;
+}
+
+void Ledger::prepend(Ledger base) {
+    base.entries.reserve(base.entries.size() + entries.size());
+    for (const LedgerEntry& own : entries) {
+        LedgerEntry entry = own;
+        if (entry.memo != NO_MEMO) entry.memo = base.storeText(memoOf(own));
+        if (entry.flags & ENTRY_BIG_AMOUNT) entry.amount = base.storeText(textAt(static_cast<uint64_t>(own.amount)));
+        base.entries.push_back(entry);
+    }
+    entries = std::move(base.entries);
+    textPool = std::move(base.textPool);
+    openingBalance = base.openingBalance;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "money.h"
+
+enum class EntryDirection : uint8_t {
+    MONEY_IN = 0,
+    MONEY_OUT = 1
+};
+
+// One ledger record. Fixed size and trivially copyable so the whole vector
+// can be written and read back with a single memcpy.
+struct LedgerEntry {
+    int64_t timestamp;      // Seconds since the Unix epoch
+    int64_t amount;         // Magnitude in Amount units, or text pool offset when ENTRY_BIG_AMOUNT is set
+    uint32_t counterparty;  // Borrower id, NO_COUNTERPARTY for plain transactions
+    uint32_t memo;          // Text pool offset, NO_MEMO when absent
+    EntryDirection direction;
+    uint8_t flags;
+    uint8_t reserved[6];
+};
+
+static_assert(sizeof(LedgerEntry) == 32, "LedgerEntry must stay 32 bytes");
+static_assert(std::is_trivially_copyable<LedgerEntry>::value, "LedgerEntry must be trivially copyable");
+
+// A closed calendar year of history, moved out of the snapshot into a segment
+// file of its own (see archiveClosedYears in account.h)
+struct LedgerSegment {
+    int32_t year = 0;        // UTC year; segments never overlap and are kept oldest first
+    uint64_t entryCount = 0;
+    int64_t minTime = 0;
+    int64_t maxTime = 0;
+    Amount openingBalance;
+    Amount closingBalance;   // Opening balance of the next segment or of the live ledger
+};
+
+// Append-only transaction history with a maintained running balance
+class Ledger {
+public:
+    static constexpr uint32_t NO_COUNTERPARTY = 0xFFFFFFFFu;
+    static constexpr uint32_t NO_MEMO = 0xFFFFFFFFu;
+    static constexpr uint8_t ENTRY_BIG_AMOUNT = 0x01;
+
+    // Drop all history and start again from the given balance
+    void reset(const Amount& openingBalance);
+
+    // Record a signed amount (positive = money in) and update the running balance
+    void append(const Amount& signedAmount, uint32_t counterparty = NO_COUNTERPARTY, std::string_view memo = {}, int64_t timestamp = currentTimestamp());
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    const std::vector<LedgerEntry>& getEntries() const { return entries; }
+    // Memos and oversized amounts that entries point into
+    std::string_view getTextPool() const { return textPool; }
+
+    // Signed amount of an entry (negative for MONEY_OUT)
+    Amount amountOf(const LedgerEntry& entry) const;
+    std::string_view memoOf(const LedgerEntry& entry) const;
+
+    const Amount& getOpeningBalance() const { return openingBalance; }
+    const Amount& getBalance() const { return balance; }
+
+    // Append the binary ledger block (entries, text pool, trailing footer) to out
+    void appendTo(std::string& out) const;
+
+    // Load a ledger block from the end of data. Returns the size of the payload
+    // that precedes it; when data has no ledger block the ledger is reset to empty
+    // and data.size() is returned.
+    size_t loadFrom(std::string_view data);
+
+    // Entries [first, last) as a ledger of their own starting at opening, with
+    // only the text those entries use
+    Ledger slice(size_t first, size_t last, const Amount& opening) const;
+
+    // Take over history read from a block save (text offsets are bounds-checked on use)
+    void restore(std::vector<LedgerEntry> loadedEntries, std::string loadedTextPool, const Amount& opening, const Amount& current);
+
+    // Put history read later (ending at this ledger's opening balance) in front
+    // of the entries appended since
+    void prepend(Ledger base);
+
+    static int64_t currentTimestamp();
+    // UTC calendar year of a timestamp
+    static int32_t yearOf(int64_t timestamp);
+
+private:
+    std::vector<LedgerEntry> entries;
+    std::string textPool;  // Length-prefixed memos and oversized amounts
+    Amount openingBalance;
+    Amount balance;
+
+    uint32_t storeText(std::string_view text);
+    std::string_view textAt(uint64_t offset) const;
+};
@@ -0,0 +1,117 @@
+#include "ledgerIndex.h"
+#include <algorithm>
+#include <limits>
+
+void LedgerIndex::RunningSums::push(const Amount& value) {
+    int64_t last = units.empty() ? 0 : units.back();
+    Amount sum = Amount::fromUnits(last) + value;
+    if (sum.isFast()) {
+        units.push_back(sum.rawUnits());
+        return;
+    }
+    units.push_back(last);
+    bigPositions.push_back(units.size() - 1);
+    bigTotals.push_back(bigTotals.empty() ? value : bigTotals.back() + value);
+}
+
+Amount LedgerIndex::RunningSums::sumOf(size_t first) const {
+    if (first == 0) return Amount();
+    Amount total = Amount::fromUnits(units[first - 1]);
+    size_t bigCount = std::lower_bound(bigPositions.begin(), bigPositions.end(), first) - bigPositions.begin();
+    if (bigCount > 0) total += bigTotals[bigCount - 1];
+    return total;
+}
+
+void LedgerIndex::clear() {
+    blockTimes.clear();
+    blockSums = RunningSums();
+    counterparties.clear();
+    count = 0;
+    opening = Amount();
+    pendingBlock = Amount();
+    latestTime = std::numeric_limits<int64_t>::min();
+    syncedFirstTime = 0;
+    synced = false;
+}
+
+bool LedgerIndex::sync(const Ledger& ledger) {
+    const std::vector<LedgerEntry>& entries = ledger.getEntries();
+    bool rebuilt = !synced || entries.size() < count || ledger.getOpeningBalance().compare(opening) != 0 ||
+                   (count > 0 && entries[0].timestamp != syncedFirstTime);
+    if (rebuilt) {
+        clear();
+        opening = ledger.getOpeningBalance();
+        if (!entries.empty()) syncedFirstTime = entries[0].timestamp;
+        synced = true;
+    }
+
+    for (size_t i = count; i < entries.size(); i++) {
+        const LedgerEntry& entry = entries[i];
+        Amount amount = ledger.amountOf(entry);
+        latestTime = std::max(latestTime, entry.timestamp);
+        pendingBlock += amount;
+        if ((i + 1) % BLOCK_SPAN == 0) {
+            blockTimes.push_back(latestTime);
+            blockSums.push(pendingBlock);
+            pendingBlock = Amount();
+        }
+
+        if (entry.counterparty != Ledger::NO_COUNTERPARTY) {
+            if (entry.counterparty >= counterparties.size()) counterparties.resize(entry.counterparty + size_t(1));
+            CounterpartyHistory& history = counterparties[entry.counterparty];
+            history.times.push_back(latestTime);
+            history.sums.push(amount);
+        }
+    }
+    count = entries.size();
+    return rebuilt;
+}
+
+size_t LedgerIndex::countAt(const Ledger& ledger, int64_t time) const {
+    // First block whose latest timestamp is past time; everything before it counts
+    size_t block = std::upper_bound(blockTimes.begin(), blockTimes.end(), time) - blockTimes.begin();
+    int64_t latest = block == 0 ? std::numeric_limits<int64_t>::min() : blockTimes[block - 1];
+    const std::vector<LedgerEntry>& entries = ledger.getEntries();
+    size_t end = std::min(count, (block + 1) * BLOCK_SPAN);
+    size_t index = block * BLOCK_SPAN;
+    for (; index < end; index++) {
+        latest = std::max(latest, entries[index].timestamp);
+        if (latest > time) break;
+    }
+    return index;
+}
+
+Amount LedgerIndex::balanceAt(const Ledger& ledger, int64_t time) const {
+    size_t entryCount = countAt(ledger, time);
+    size_t block = entryCount / BLOCK_SPAN;
+    Amount balance = opening + blockSums.sumOf(block);
+    const std::vector<LedgerEntry>& entries = ledger.getEntries();
+    for (size_t i = block * BLOCK_SPAN; i < entryCount; i++) {
+        balance += ledger.amountOf(entries[i]);
+    }
+    return balance;
+}
+
+Amount LedgerIndex::flowBetween(const Ledger& ledger, int64_t from, int64_t to) const {
+    if (to <= from) return Amount();
+    return balanceAt(ledger, to) - balanceAt(ledger, from);
+}
+
+Amount LedgerIndex::counterpartyFlowUntil(uint32_t counterparty, int64_t time) const {
+    if (counterparty >= counterparties.size()) return Amount();
+    const CounterpartyHistory& history = counterparties[counterparty];
+    size_t entryCount = std::upper_bound(history.times.begin(), history.times.end(), time) - history.times.begin();
+    return history.sums.sumOf(entryCount);
+}
+
+Amount LedgerIndex::counterpartyFlowBetween(uint32_t counterparty, int64_t from, int64_t to) const {
+    if (to <= from) return Amount();
+    return counterpartyFlowUntil(counterparty, to) - counterpartyFlowUntil(counterparty, from);
+}
+
+Amount LedgerIndex::counterpartyBalanceAt(uint32_t counterparty, int64_t time, const Amount& currentBalance) const {
+    if (counterparty >= counterparties.size()) return currentBalance;
+    const CounterpartyHistory& history = counterparties[counterparty];
+    Amount later = history.sums.sumOf(history.times.size()) - counterpartyFlowUntil(counterparty, time);
+    return currentBalance - later;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ledger.h"
+
+// Point-in-time balance and net-flow queries over an append-only ledger.
+// The ledger is cut into blocks of BLOCK_SPAN entries, each with the running
+// sum and the latest timestamp up to its end, so a query is a binary search
+// over blocks plus a scan of at most one block. Counterparty entries also get
+// running sums of their own per id. Kept in step with the ledger by sync(),
+// which only reads entries appended since the previous call.
+//
+// An entry stamped earlier than one before it (clock changes) counts as made
+// at that latest earlier time, the same rule year segments use.
+class LedgerIndex {
+public:
+    static constexpr size_t BLOCK_SPAN = 32;
+
+    void clear();
+
+    // Catch up with the ledger. Returns true when it was reset, loaded or
+    // trimmed since the last call and the index was rebuilt from scratch.
+    bool sync(const Ledger& ledger);
+
+    // Entries covered (equals the ledger size after sync)
+    size_t size() const { return count; }
+
+    // Number of entries made at or before time
+    size_t countAt(const Ledger& ledger, int64_t time) const;
+
+    // Account balance after every entry made at or before time
+    Amount balanceAt(const Ledger& ledger, int64_t time) const;
+    // Sum of the entries made in (from, to]
+    Amount flowBetween(const Ledger& ledger, int64_t from, int64_t to) const;
+
+    // Sum of a counterparty's entries made at or before time
+    Amount counterpartyFlowUntil(uint32_t counterparty, int64_t time) const;
+    // Sum of a counterparty's entries made in (from, to]
+    Amount counterpartyFlowBetween(uint32_t counterparty, int64_t from, int64_t to) const;
+    // Counterparty balance at time, walking back from its balance after the
+    // last indexed entry (balances may predate the ledger, so they are not
+    // rebuilt from zero)
+    Amount counterpartyBalanceAt(uint32_t counterparty, int64_t time, const Amount& currentBalance) const;
+
+private:
+    // Running sums kept in int64 units; values that do not fit are summed
+    // apart as exact amounts
+    struct RunningSums {
+        std::vector<int64_t> units;         // units[i] = fast part of values [0, i]
+        std::vector<size_t> bigPositions;   // Positions of the values kept apart
+        std::vector<Amount> bigTotals;      // bigTotals[k] = sum of the first k + 1 of them
+
+        void push(const Amount& value);
+        Amount sumOf(size_t first) const;   // Sum of the first values
+    };
+
+    struct CounterpartyHistory {
+        std::vector<int64_t> times;  // Effective time of each entry, non-decreasing
+        RunningSums sums;
+    };
+
+    std::vector<int64_t> blockTimes;  // Latest timestamp up to the end of each full block
+    RunningSums blockSums;
+    std::vector<CounterpartyHistory> counterparties;  // Indexed by counterparty id
+
+    size_t count = 0;
+    Amount opening;
+    Amount pendingBlock;  // Sum of the entries after the last full block
+    int64_t latestTime = 0;
+
+    // What the index was built from, to notice a replaced ledger
+    int64_t syncedFirstTime = 0;
+    bool synced = false;
+};
@@ -5,8 +5,6 @@
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include "misc/cpp/imgui_stdlib.h"
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
 #include <iostream>
 #include <map>
 #include <vector>
@@ -15,302 +13,53 @@
 #include <string>
 #include <algorithm>
 #include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
 
 // Your existing headers
-#include "encrypter.h"
+#include "account.h"
 #include "savingFunctions.h"
-
-const std::string DATA_FILE = "saves.data";
+#include "money.h"
+#include "balanceHistory.h"
+#include "ledgerIndex.h"
+#include "nameIndex.h"
+#include "fontCache.h"
+#include "appIcon.h" // Generated at build time from resources/app_icon.png
 
 void SetGLFWWindowIcon(GLFWwindow* window) {
-    GLFWimage icon;
-    icon.pixels = stbi_load("resources/app_icon.png", &icon.width, &icon.height, 0, 4); // 4 = RGBA
-    if (icon.pixels) {
-        glfwSetWindowIcon(window, 1, &icon);
-        stbi_image_free(icon.pixels);
-    } else {
-        fprintf(stderr, "Failed to load window icon\n");
+    // Pre-decoded at build time; GLFW copies the pixels and picks the best size
+    const int count = sizeof(APP_ICONS) / sizeof(APP_ICONS[0]);
+    GLFWimage icons[count];
+    for (int i = 0; i < count; i++) {
+        icons[i].width = APP_ICONS[i].width;
+        icons[i].height = APP_ICONS[i].height;
+        icons[i].pixels = const_cast<unsigned char*>(APP_ICONS[i].pixels);
     }
+    glfwSetWindowIcon(window, count, icons);
 }
 
-// Big Number class for handling arbitrarily large numbers
-class BigNumber {
-private:
-    std::string number;
-    bool negative;
-    
-    // Remove leading zeros
-    void normalize() {
-        size_t pos = number.find_first_not_of('0');
-        if (pos == std::string::npos) {
-            number = "0";
-            negative = false;
-        } else {
-            number = number.substr(pos);
-        }
-        if (number.empty()) {
-            number = "0";
-            negative = false;
-        }
-    }
-    
-    // Compare absolute values (returns: -1 if this < other, 0 if equal, 1 if this > other)
-    int compareAbs(const BigNumber& other) const {
-        if (number.length() < other.number.length()) return -1;
-        if (number.length() > other.number.length()) return 1;
-        return number.compare(other.number);
-    }
-    
-    std::string addPositive(const std::string& a, const std::string& b) const {
-        // Find decimal points
-        size_t decimalA = a.find('.');
-        size_t decimalB = b.find('.');
-        
-        // If no decimal points, use original logic
-        if (decimalA == std::string::npos && decimalB == std::string::npos) {
-            // Your original integer addition code here
-            std::string result;
-            int carry = 0;
-            int i = a.length() - 1;
-            int j = b.length() - 1;
-            
-            while (i >= 0 || j >= 0 || carry > 0) {
-                int sum = carry;
-                if (i >= 0) sum += (a[i--] - '0');
-                if (j >= 0) sum += (b[j--] - '0');
-                
-                result = char(sum % 10 + '0') + result;
-                carry = sum / 10;
-            }
-            return result;
-        }
-        
-        // Handle decimal numbers
-        std::string intA = (decimalA == std::string::npos) ? a : a.substr(0, decimalA);
-        std::string fracA = (decimalA == std::string::npos) ? "" : a.substr(decimalA + 1);
-        std::string intB = (decimalB == std::string::npos) ? b : b.substr(0, decimalB);
-        std::string fracB = (decimalB == std::string::npos) ? "" : b.substr(decimalB + 1);
-        
-        // Pad fractional parts to same length
-        while (fracA.length() < fracB.length()) fracA += "0";
-        while (fracB.length() < fracA.length()) fracB += "0";
-        
-        // Add fractional parts first
-        std::string fracResult;
-        int carry = 0;
-        for (int i = fracA.length() - 1; i >= 0; i--) {
-            int sum = carry + (fracA[i] - '0') + (fracB[i] - '0');
-            fracResult = char(sum % 10 + '0') + fracResult;
-            carry = sum / 10;
-        }
-        
-        // Add integer parts
-        std::string intResult;
-        int i = intA.length() - 1;
-        int j = intB.length() - 1;
-        
-        while (i >= 0 || j >= 0 || carry > 0) {
-            int sum = carry;
-            if (i >= 0) sum += (intA[i--] - '0');
-            if (j >= 0) sum += (intB[j--] - '0');
-            
-            intResult = char(sum % 10 + '0') + intResult;
-            carry = sum / 10;
-        }
-        
-        // Combine results
-        if (fracResult.empty()) return intResult;
-        return intResult + "." + fracResult;
-    }
-    
-    // Subtract two positive numbers (assumes a >= b)
-    std::string subtractPositive(const std::string& a, const std::string& b) const {
-        // Find decimal points
-        size_t decimalA = a.find('.');
-        size_t decimalB = b.find('.');
-        
-        // If no decimal points, use original logic
-        if (decimalA == std::string::npos && decimalB == std::string::npos) {
-            // Your original integer subtraction code here
-            std::string result;
-            int borrow = 0;
-            int i = a.length() - 1;
-            int j = b.length() - 1;
-            
-            while (i >= 0) {
-                int sub = (a[i] - '0') - borrow;
-                if (j >= 0) sub -= (b[j--] - '0');
-                
-                if (sub < 0) {
-                    sub += 10;
-                    borrow = 1;
-                } else {
-                    borrow = 0;
-                }
-                
-                result = char(sub + '0') + result;
-                i--;
-            }
-            return result;
-        }
-        
-        // Handle decimal numbers
-        std::string intA = (decimalA == std::string::npos) ? a : a.substr(0, decimalA);
-        std::string fracA = (decimalA == std::string::npos) ? "" : a.substr(decimalA + 1);
-        std::string intB = (decimalB == std::string::npos) ? b : b.substr(0, decimalB);
-        std::string fracB = (decimalB == std::string::npos) ? "" : b.substr(decimalB + 1);
-        
-        // Pad fractional parts to same length
-        while (fracA.length() < fracB.length()) fracA += "0";
-        while (fracB.length() < fracA.length()) fracB += "0";
-        
-        // Subtract fractional parts first
-        std::string fracResult;
-        int borrow = 0;
-        for (int i = fracA.length() - 1; i >= 0; i--) {
-            int sub = (fracA[i] - '0') - borrow - (fracB[i] - '0');
-            
-            if (sub < 0) {
-                sub += 10;
-                borrow = 1;
-            } else {
-                borrow = 0;
-            }
-            
-            fracResult = char(sub + '0') + fracResult;
-        }
-        
-        // Subtract integer parts
-        std::string intResult;
-        int i = intA.length() - 1;
-        int j = intB.length() - 1;
-        
-        while (i >= 0) {
-            int sub = (intA[i] - '0') - borrow;
-            if (j >= 0) sub -= (intB[j--] - '0');
-            
-            if (sub < 0) {
-                sub += 10;
-                borrow = 1;
-            } else {
-                borrow = 0;
-            }
-            
-            intResult = char(sub + '0') + intResult;
-            i--;
-        }
-        
-        // Remove trailing zeros from fractional part
-        while (!fracResult.empty() && fracResult.back() == '0') {
-            fracResult.pop_back();
-        }
-        
-        // Combine results
-        if (fracResult.empty()) return intResult;
-        return intResult + "." + fracResult;
-    }
-    
-public:
-    BigNumber() : number("0"), negative(false) {}
-    
-    BigNumber(const std::string& str) {
-        if (str.empty() || str == "0") {
-            number = "0";
-            negative = false;
-            return;
-        }
-        
-        negative = (str[0] == '-');
-        number = negative ? str.substr(1) : str;
-        
-        // Validate that it's all digits (allow decimal point)
-        bool hasDecimal = false;
-        std::string cleanNumber;
-        for (char c : number) {
-            if (c == '.') {
-                if (hasDecimal) {
-                    number = "0";
-                    negative = false;
-                    return;
-                }
-                hasDecimal = true;
-                cleanNumber += c;  // Add this line to preserve the decimal point
-            } else if (std::isdigit(c)) {
-                cleanNumber += c;
-            } else {
-                number = "0";
-                negative = false;
-                return;
-            }
-        }
+// Wall-clock time of each startup phase, printed to stderr when the
+// MONEYTRACKER_STARTUP_TIMING environment variable is set
+struct StartupTimer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last = start;
+    std::string phases;
 
-        number = cleanNumber.empty() ? "0" : cleanNumber;
-        normalize();
-    }
-    
-    BigNumber(long long val) {
-        if (val < 0) {
-            negative = true;
-            val = -val;
-        } else {
-            negative = false;
-        }
-        number = std::to_string(val);
+    void mark(const char* phase) {
+        auto now = std::chrono::steady_clock::now();
+        char line[96];
+        std::snprintf(line, sizeof(line), "  %-16s %8.2f ms\n", phase, std::chrono::duration<double, std::milli>(now - last).count());
+        phases += line;
+        last = now;
     }
-    
-    std::string toString() const {
-        if (number == "0") return "0";
-        return (negative ? "-" : "") + number;
-    }
-    
-    bool isZero() const {
-        return number == "0";
-    }
-    
-    bool isNegative() const {
-        return negative && !isZero();
-    }
-    
-    BigNumber operator+(const BigNumber& other) const {
-        BigNumber result;
-        
-        if (negative == other.negative) {
-            // Same signs: add absolute values
-            result.number = addPositive(number, other.number);
-            result.negative = negative;
-        } else {
-            // Different signs: subtract absolute values
-            int cmp = compareAbs(other);
-            if (cmp == 0) {
-                result.number = "0";
-                result.negative = false;
-            } else if (cmp > 0) {
-                result.number = subtractPositive(number, other.number);
-                result.negative = negative;
-            } else {
-                result.number = subtractPositive(other.number, number);
-                result.negative = other.negative;
-            }
-        }
-        
-        result.normalize();
-        return result;
-    }
-    
-    BigNumber operator-(const BigNumber& other) const {
-        BigNumber temp = other;
-        temp.negative = !temp.negative;
-        return *this + temp;
-    }
-    
-    BigNumber& operator+=(const BigNumber& other) {
-        *this = *this + other;
-        return *this;
-    }
-    
-    BigNumber& operator-=(const BigNumber& other) {
-        *this = *this - other;
-        return *this;
+
+    void report() const {
+        if (std::getenv("MONEYTRACKER_STARTUP_TIMING") == nullptr) return;
+        std::fprintf(stderr, "Startup timing:\n%s  %-16s %8.2f ms\n", phases.c_str(), "total",
+            std::chrono::duration<double, std::milli>(last - start).count());
     }
 };
 
@@ -323,17 +72,117 @@ enum class AppState {
     TRANSACTION,
     NOTE,
     BORROWERS,
+    HISTORY,
     RESET_CONFIRM
 };
 
-struct AppData {
+// One pre-formatted borrower/lender table row
+struct BorrowerRow {
+    std::string name;
+    std::string amountText;  // "$..." without the sign
+    std::string activityText; // Date of the newest ledger entry, "-" if none
+    bool owesYou = false;    // Negative balance: they borrowed from you
+};
+
+// Pre-formatted dashboard strings, rebuilt only after the underlying data changes
+struct DashboardView {
+    bool dirty = true;
+    bool rowsDirty = true;
+    bool totalNegative = false;
+    bool hasNote = false;
+    
+    std::string totalText;            // "Total Money: $..."
+    std::string currentTotalText;     // "Current Total: $..."
+    std::string lastTransactionText;  // "Last Transaction: ..."
+    std::string noteText;             // "Note: ..."
+    std::string shortNoteText;        // "Short Note: ..."
+    std::string loansText;            // "Owed to you: $... (n)   You owe: $... (n)"
+    std::string netWorthText;         // "Net worth incl. loans: $..."
+    std::string largestText;          // "Largest: name $...", empty without loans
+    
+    float totalWidth = 0.0f;
+    float currentTotalWidth = 0.0f;
+    float lastTransactionWidth = 0.0f;
+    float noteWidth = 0.0f;
+    float shortNoteWidth = 0.0f;
+    float loansWidth = 0.0f;
+    float netWorthWidth = 0.0f;
+    float largestWidth = 0.0f;
+    
+    std::vector<BorrowerRow> borrowerRows;  // Indexed by counterparty id
+};
+
+// Borrower table columns; also the ImGui column user ids used for sorting
+enum BorrowerColumn : ImGuiID {
+    COLUMN_STATUS,
+    COLUMN_NAME,
+    COLUMN_AMOUNT,
+    COLUMN_ACTIVITY
+};
+
+// Sort choice and cached row order for one borrower table
+struct BorrowerTableState {
+    bool sorted = false;  // False shows rows in insertion order
+    ImGuiID sortColumn = COLUMN_NAME;
+    bool descending = false;
+    uint64_t orderGeneration = 0;  // Row generation the order was built for, 0 = stale
+    std::vector<uint32_t> order;   // Counterparty ids in display order
+};
+
+// Visible part of the balance chart, in ledger entries (fractional so slow drags still pan)
+struct BalanceChartState {
+    double first = 0.0;
+    double count = 0.0;        // 0 = show the whole history
+    bool followLatest = true;  // Keep the newest entry in view as entries are added
+    std::vector<BalanceRange> columns;  // Reused every frame
+    std::vector<ImVec2> points;
+};
+
+using Clock = std::chrono::steady_clock;
+
+const double STATUS_SECONDS = 4.0;        // How long a status message stays visible
+const double CURSOR_BLINK_SECONDS = 0.5;  // Redraw interval while a text field has focus
+const int SETTLE_FRAMES = 2;              // Extra frames after a wake-up (hover/popups lag one frame)
+const double LOGIN_PROGRESS_SECONDS = 0.1;  // Progress bar refresh interval while a login loads
+const double AUTOSAVE_DELAY_SECONDS = 2.0;  // After the first unsaved change, so bursts share one write
+const double AUTOSAVE_RETRY_SECONDS = 30.0; // After a failed autosave
+
+// Local date for a ledger timestamp, "-" when there is none
+std::string formatDate(int64_t timestamp) {
+    if (timestamp <= 0) return "-";
+    std::time_t time = static_cast<std::time_t>(timestamp);
+    std::tm* local = std::localtime(&time);
+    char text[16];
+    if (local == nullptr || std::strftime(text, sizeof(text), "%Y-%m-%d", local) == 0) return "-";
+    return text;
+}
+
+// Last second of a local "YYYY-MM-DD" day; false if the text is not a valid date
+bool parseEndOfDay(const std::string& text, int64_t& out) {
+    int year = 0, month = 0, day = 0;
+    char extra = 0;
+    if (std::sscanf(text.c_str(), "%d-%d-%d%c", &year, &month, &day, &extra) != 3) return false;
+    if (year < 1970 || month < 1 || month > 12 || day < 1 || day > 31) return false;
+    
+    std::tm local = {};
+    local.tm_year = year - 1900;
+    local.tm_mon = month - 1;
+    local.tm_mday = day + 1;  // Midnight that ends the day; mktime normalises overflow
+    local.tm_isdst = -1;
+    std::time_t next = std::mktime(&local);
+    if (next == static_cast<std::time_t>(-1)) return false;
+    out = static_cast<int64_t>(next) - 1;
+    
+    // Rejects days past the end of the month, which mktime would roll over
+    char expected[16];
+    std::snprintf(expected, sizeof(expected), "%04d-%02d-%02d", year, month, day);
+    return formatDate(out) == expected;
+}
+
+// GUI state on top of the account data and save pipeline (account.h)
+struct AppData : Account {
     AppState currentState = AppState::LOGIN;
-    std::map<std::string, std::string> dataMap;
-    std::map<std::string, std::string> borrowersMap;
-    std::vector<std::string> orderVector;
-    std::string userKey;
     bool dataLoaded = false;
-    bool fileExists = false;
     
     // GUI input strings (safer than char buffers)
     std::string passwordInput;
@@ -342,6 +191,29 @@ struct AppData {
     std::string noteInput;
     std::string borrowerNameInput;
     std::string borrowerValueInput;
+    std::string borrowerSearchInput;
+    
+    // Sort state of the dashboard and borrowers-screen tables
+    BorrowerTableState dashboardTable;
+    BorrowerTableState borrowersTable;
+    
+    // Balance chart (View Data screen), summarised once and kept in step with the ledger
+    BalanceHistory balanceHistory;
+    BalanceChartState balanceChart;
+    
+    // Date queries (History screen)
+    LedgerIndex ledgerIndex;
+    std::string historyDateInput;
+    std::string historyCompareInput;
+    std::string historyNameInput;
+    std::vector<std::string> historyLines;  // Results of the last query
+    bool historyWaiting = false;             // The query runs again once deferred ledger entries are read
+    
+    // One closed year, loaded from its segment file when a query reaches back into it
+    int32_t archivedYear = 0;  // 0 = none loaded
+    Ledger archivedLedger;
+    LedgerIndex archivedIndex;
+    std::vector<Amount> archivedBalances;  // Counterparty balances at the end of that year
     
     // GUI state
     bool showDemo = false;
@@ -350,11 +222,48 @@ struct AppData {
     bool showResetDialog = false;
     bool showErrorAlert = false;
     std::string statusMessage;
+    Clock::time_point statusExpiry;
+    bool autosaveScheduled = false;
+    Clock::time_point autosaveDue;
+    
+    // Login decrypts and parses on its own thread; the login screen polls it
+    std::thread loginThread;
+    std::atomic<bool> loginRunning{ false };
+    LoginResult loginResult = LoginResult::SUCCESS;
+    LoadProgress loadProgress;
+    
+    ~AppData() {
+        loadProgress.cancelled = true;
+        if (loginThread.joinable()) {
+            loginThread.join();
+        }
+    }
+    
+    void startLogin() {
+        loadProgress.bytesTotal = 0;
+        loadProgress.bytesDecrypted = 0;
+        loadProgress.recordsParsed = 0;
+        loadProgress.cancelled = false;
+        loginRunning = true;
+        loginThread = std::thread([this, password = passwordInput]() {
+            loginResult = loginAccount(*this, password, &loadProgress);
+            loginRunning = false;
+            if (backgroundDone) backgroundDone();
+        });
+    }
+    
+    // True once when a started login has finished; the outcome is in loginResult
+    bool finishLogin() {
+        if (loginRunning || !loginThread.joinable()) return false;
+        loginThread.join();
+        return true;
+    }
     std::string alertMessage;
     ImVec4 statusColor = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
     
     void setStatus(const std::string& msg, ImVec4 color = ImVec4(1.0f, 1.0f, 1.0f, 1.0f)) {
         statusMessage = msg;
+        statusExpiry = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(STATUS_SECONDS));
         statusColor = color;
     }
     
@@ -362,6 +271,194 @@ struct AppData {
         alertMessage = msg;
         showErrorAlert = true;
     }
+    
+    // Wall-clock status timeout, independent of how often frames are drawn
+    void expireStatus() {
+        if (!statusMessage.empty() && Clock::now() >= statusExpiry) {
+            statusMessage.clear();
+        }
+    }
+    
+    // Once per frame: collect a finished autosave and start the next one when due.
+    // The write runs on the account's worker thread, so a frame never waits on disk.
+    void autosave() {
+        if (loginRunning) return; // The login thread owns the account until it finishes
+        bool deferred = ledgerDeferred;
+        SaveResult result = finishSave(*this);
+        if (deferred && !ledgerDeferred) {
+            // Older entries now sit in front of the ones the chart and index were built from
+            balanceHistory.clear();
+            ledgerIndex.clear();
+        }
+        switch (result) {
+            case SaveResult::SAVED:
+                if (startCompactionIfDue(*this)) {
+                    setStatus("All changes saved, compacting...", ImVec4(0.6f, 0.6f, 0.6f, 1.0f));
+                } else {
+                    setStatus("All changes saved", ImVec4(0.6f, 0.6f, 0.6f, 1.0f));
+                }
+                break;
+            case SaveResult::FAILED:
+                setStatus("Autosave failed, retrying...", ImVec4(1.0f, 0.3f, 0.3f, 1.0f));
+                autosaveScheduled = true;
+                autosaveDue = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(AUTOSAVE_RETRY_SECONDS));
+                break;
+            case SaveResult::NONE:
+                break;
+        }
+        
+        if (!dataLoaded || (fileExists && pendingMutations.empty())) return;
+        if (!autosaveScheduled) {
+            autosaveScheduled = true;
+            autosaveDue = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(AUTOSAVE_DELAY_SECONDS));
+        } else if (Clock::now() >= autosaveDue && startSave(*this)) {
+            autosaveScheduled = false;
+            setStatus("Saving...", ImVec4(0.6f, 0.6f, 0.6f, 1.0f));
+        }
+    }
+    
+    // Seconds until something on screen changes without input, negative if nothing will
+    double secondsUntilNextRedraw() const {
+        double wait = -1.0;
+        if (!statusMessage.empty()) {
+            wait = std::max(0.0, std::chrono::duration<double>(statusExpiry - Clock::now()).count());
+        }
+        if (loginRunning) {
+            wait = (wait < 0.0) ? LOGIN_PROGRESS_SECONDS : std::min(wait, LOGIN_PROGRESS_SECONDS);
+        }
+        if (autosaveScheduled && !workerRunning) { // A running job wakes the loop itself (backgroundDone)
+            double due = std::max(0.0, std::chrono::duration<double>(autosaveDue - Clock::now()).count());
+            wait = (wait < 0.0) ? due : std::min(wait, due);
+        }
+        if (ImGui::GetIO().WantTextInput) {
+            wait = (wait < 0.0) ? CURSOR_BLINK_SECONDS : std::min(wait, CURSOR_BLINK_SECONDS);
+        }
+        return wait;
+    }
+    
+    // Call after any change to dataMap/counterparties so the next frame re-formats.
+    // Borrower rows are only rebuilt when borrowers changed.
+    void invalidateView(bool borrowersChanged = true) {
+        view.dirty = true;
+        view.rowsDirty = view.rowsDirty || borrowersChanged;
+    }
+    
+    // Re-run the borrower search; call whenever borrowerSearchInput changes
+    void updateSearch() {
+        searchMatches = nameIndex.search(borrowerSearchInput);
+        rowGeneration++;
+    }
+    
+    // Rows matching the search box, or nullptr to show every row
+    const NameIndex::Matches* getSearchMatches() const {
+        return borrowerSearchInput.empty() ? nullptr : &searchMatches;
+    }
+    
+    // Must be called inside an ImGui frame (text widths need the current font)
+    const DashboardView& getView() {
+        if (view.dirty) {
+            rebuildView();
+        }
+        return view;
+    }
+    
+    // Display order for a sorted table (nullptr when unsorted). Starts from the
+    // name-ordered index so ties stay alphabetical, and is only rebuilt after the
+    // rows, the search or the sort column change.
+    const std::vector<uint32_t>* getSortedOrder(BorrowerTableState& table, const NameIndex::Matches* matches) {
+        if (!table.sorted) return nullptr;
+        if (table.orderGeneration == rowGeneration) return &table.order;
+        
+        NameIndex::Matches base = matches ? *matches : nameIndex.search("");
+        table.order.assign(base.ids, base.ids + base.count);
+        
+        bool descending = table.descending;
+        switch (table.sortColumn) {
+            case COLUMN_AMOUNT:
+                std::stable_sort(table.order.begin(), table.order.end(), [this, descending](uint32_t a, uint32_t b) {
+                    int order = counterparties.compareBalances(a, b);
+                    return descending ? order > 0 : order < 0;
+                });
+                break;
+            case COLUMN_ACTIVITY:
+                std::stable_sort(table.order.begin(), table.order.end(), [this, descending](uint32_t a, uint32_t b) {
+                    int64_t left = counterparties.lastActivityOf(a);
+                    int64_t right = counterparties.lastActivityOf(b);
+                    return descending ? left > right : left < right;
+                });
+                break;
+            default:
+                if (descending) std::reverse(table.order.begin(), table.order.end());
+                break;
+        }
+        table.orderGeneration = rowGeneration;
+        return &table.order;
+    }
+    
+private:
+    DashboardView view;
+    NameIndex nameIndex;
+    NameIndex::Matches searchMatches;
+    uint64_t rowGeneration = 1;  // Bumped when borrower rows or search results change
+    
+    void rebuildView() {
+        Amount totalMoney(dataMap["Total Money"]);
+        std::string total = totalMoney.toString();
+        const std::string& lastTransaction = dataMap["Last Transaction"];
+        const std::string& shortNote = dataMap["Short Note"];
+        
+        view.totalNegative = totalMoney.isNegative();
+        view.hasNote = (shortNote != "-");
+        view.totalText = "Total Money: $" + total;
+        view.currentTotalText = "Current Total: $" + total;
+        view.lastTransactionText = "Last Transaction: " + lastTransaction;
+        view.noteText = "Note: " + shortNote;
+        view.shortNoteText = "Short Note: " + shortNote;
+        
+        // Loan aggregates are maintained by the counterparty table, so this is O(1)
+        const CounterpartyTotals& totals = counterparties.totals();
+        view.loansText = "Owed to you: $" + totals.owedToYou.toString() + " (" + std::to_string(totals.owingYouCount) + ")" +
+                         "   You owe: $" + totals.youOwe.toString() + " (" + std::to_string(totals.youOweCount) + ")";
+        view.netWorthText = "Net worth incl. loans: $" + (totalMoney + totals.owedToYou - totals.youOwe).toString();
+        uint32_t largest = counterparties.largestExposure();
+        view.largestText.clear();
+        if (largest != CounterpartyTable::NOT_FOUND) {
+            const Amount& balance = counterparties.balanceOf(largest);
+            view.largestText = "Largest: " + counterparties.nameOf(largest) +
+                               (balance.isNegative() ? " owes you $" + (-balance).toString() : " is owed $" + balance.toString());
+        }
+        
+        view.totalWidth = ImGui::CalcTextSize(view.totalText.c_str()).x;
+        view.currentTotalWidth = ImGui::CalcTextSize(view.currentTotalText.c_str()).x;
+        view.lastTransactionWidth = ImGui::CalcTextSize(view.lastTransactionText.c_str()).x;
+        view.noteWidth = ImGui::CalcTextSize(view.noteText.c_str()).x;
+        view.shortNoteWidth = ImGui::CalcTextSize(view.shortNoteText.c_str()).x;
+        view.loansWidth = ImGui::CalcTextSize(view.loansText.c_str()).x;
+        view.netWorthWidth = ImGui::CalcTextSize(view.netWorthText.c_str()).x;
+        view.largestWidth = ImGui::CalcTextSize(view.largestText.c_str()).x;
+        view.dirty = false;
+        
+        if (view.rowsDirty) {
+            rebuildBorrowerRows();
+        }
+    }
+    
+    void rebuildBorrowerRows() {
+        view.borrowerRows.clear();
+        view.borrowerRows.reserve(counterparties.size());
+        for (uint32_t id = 0; id < counterparties.size(); id++) {
+            std::string amount = counterparties.balanceOf(id).toString();
+            BorrowerRow row;
+            row.name = counterparties.nameOf(id);
+            row.owesYou = !amount.empty() && amount[0] == '-';
+            row.amountText = "$" + (row.owesYou ? amount.substr(1) : amount);
+            row.activityText = formatDate(counterparties.lastActivityOf(id));
+            view.borrowerRows.push_back(std::move(row));
+        }
+        nameIndex.sync(counterparties);
+        updateSearch();  // Also marks cached sort orders stale
+        view.rowsDirty = false;
+    }
 };
 
 // Enhanced utility functions with input validation
@@ -411,12 +508,6 @@ bool isValidNote(const std::string& str) {
     return str.length() <= 1000; // Reasonable limit for notes
 }
 
-std::string lowercase(std::string str) {
-    std::transform(str.begin(), str.end(), str.begin(),
-        [](unsigned char c) { return std::tolower(c); });
-    return str;
-}
-
 // GUI callback
 static void glfw_error_callback(int error, const char* description) {
     std::cerr << "GLFW Error " << error << ": " << description << std::endl;
@@ -445,22 +536,234 @@ void CenterContent(float width) {
     ImGui::SetCursorPosX((windowWidth - width) * 0.5f);
 }
 
-// Font loading function
-void LoadCustomFont(ImGuiIO& io) {
-    // Clear existing fonts first
-    io.Fonts->Clear();
+// Borrower/lender table. Only the visible rows are submitted (ImGuiListClipper)
+// and every row comes pre-formatted from the view, so cost does not grow with the list.
+// With matches set, only those ids are shown (in name order) straight from the search index.
+// Clicking a header sorts through the cached order in table; a third click restores insertion order.
+void renderBorrowerTable(AppData& app, BorrowerTableState& table, const char* tableId, const char* emptyText,
+                         const NameIndex::Matches* matches = nullptr) {
+    const DashboardView& view = app.getView();
+    size_t rowCount = matches ? matches->count : view.borrowerRows.size();
+    if (view.borrowerRows.empty() || rowCount == 0) {
+        const char* text = view.borrowerRows.empty() ? emptyText : "No matching records";
+        CenterContent(ImGui::CalcTextSize(text).x);
+        ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "%s", text);
+        return;
+    }
     
-    // Try to load Segoe UI with larger size
-    ImFont* font = io.Fonts->AddFontFromFileTTF("C:/Windows/Fonts/segoeui.ttf", 18.0f);
+    ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp |
+                            ImGuiTableFlags_Sortable | ImGuiTableFlags_SortTristate;
+    if (ImGui::BeginTable(tableId, 4, flags, ImVec2(0, ImGui::GetContentRegionAvail().y))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Status", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_NoSort, 0.0f, COLUMN_STATUS);
+        ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, 0.0f, COLUMN_NAME);
+        ImGui::TableSetupColumn("Amount", ImGuiTableColumnFlags_WidthStretch | ImGuiTableColumnFlags_PreferSortDescending, 0.0f, COLUMN_AMOUNT);
+        ImGui::TableSetupColumn("Last Activity", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, 0.0f, COLUMN_ACTIVITY);
+        ImGui::TableHeadersRow();
+        
+        ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs();
+        if (specs && specs->SpecsDirty) {
+            table.sorted = specs->SpecsCount > 0;
+            if (table.sorted) {
+                table.sortColumn = specs->Specs[0].ColumnUserID;
+                table.descending = specs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+            }
+            table.orderGeneration = 0;
+            specs->SpecsDirty = false;
+        }
+        const std::vector<uint32_t>* order = app.getSortedOrder(table, matches);
+        
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(rowCount));
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                uint32_t id = order ? (*order)[i] : (matches ? matches->ids[i] : static_cast<uint32_t>(i));
+                const BorrowerRow& row = view.borrowerRows[id];
+                ImVec4 color = row.owesYou ? ImVec4(1.0f, 0.6f, 0.6f, 1.0f) : ImVec4(0.6f, 1.0f, 0.6f, 1.0f);
+                
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextColored(color, "%s", row.owesYou ? "[OWES YOU]" : "[YOU OWE]");
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(row.name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextColored(color, "%s", row.amountText.c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(row.activityText.c_str());
+            }
+        }
+        ImGui::EndTable();
+    }
+}
+
+const double CHART_MIN_ENTRIES = 8.0;  // Deepest zoom
+const float CHART_ZOOM_STEP = 0.8f;    // Visible span per mouse wheel notch
+
+// Balance over the ledger history. Each pixel column is drawn from the summary
+// pyramid (low-high bar plus the closing balance line), so a frame costs the
+// same at any zoom. Wheel zooms around the cursor, drag pans, double-click
+// shows the whole history again.
+void renderBalanceChart(AppData& app, float height) {
+    BalanceChartState& chart = app.balanceChart;
+    if (app.ledgerDeferred) {
+        // Login left the ledger on disk; read it now that the chart needs it
+        startLedgerLoad(app);
+        const char* text = app.ledgerLoadFailed ? "Could not read the transaction history" : "Loading history...";
+        CenterContent(ImGui::CalcTextSize(text).x);
+        ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "%s", text);
+        return;
+    }
+    if (app.balanceHistory.sync(app.ledger)) {
+        chart.first = 0.0;
+        chart.count = 0.0;
+        chart.followLatest = true;
+    }
+    double total = static_cast<double>(app.balanceHistory.size());
+    if (total < 2) {
+        const char* text = "Not enough transactions for a chart";
+        CenterContent(ImGui::CalcTextSize(text).x);
+        ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "%s", text);
+        return;
+    }
+    
+    // New entries widen a full view or shift a view that shows the latest ones
+    if (chart.count <= 0.0 || chart.count > total) {
+        chart.first = 0.0;
+        chart.count = total;
+    } else if (chart.followLatest) {
+        if (chart.first > 0.0) chart.first = total - chart.count;
+        else chart.count = total;
+    }
+    
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImVec2 size(ImGui::GetContentRegionAvail().x, height);
+    ImGui::InvisibleButton("BalanceChart", size);
+    bool hovered = ImGui::IsItemHovered();
+    ImGuiIO& io = ImGui::GetIO();
+    double minCount = std::min(CHART_MIN_ENTRIES, total);
+    
+    if (hovered && ImGui::IsMouseDoubleClicked(0)) {
+        chart.first = 0.0;
+        chart.count = total;
+    } else if (hovered && io.MouseWheel != 0.0f) {
+        double anchor = chart.first + (io.MousePos.x - origin.x) / size.x * chart.count;
+        double count = std::clamp(chart.count * std::pow(CHART_ZOOM_STEP, io.MouseWheel), minCount, total);
+        chart.first = anchor - (anchor - chart.first) * count / chart.count;
+        chart.count = count;
+    } else if (ImGui::IsItemActive() && io.MouseDelta.x != 0.0f) {
+        chart.first -= io.MouseDelta.x / size.x * chart.count;
+    }
+    chart.first = std::clamp(chart.first, 0.0, total - chart.count);
+    chart.followLatest = chart.first + chart.count >= total;
+    
+    size_t first = static_cast<size_t>(chart.first);
+    size_t last = std::min(static_cast<size_t>(std::ceil(chart.first + chart.count)), static_cast<size_t>(total));
+    app.balanceHistory.sample(app.ledger, first, last, static_cast<size_t>(std::max(1.0f, size.x)), chart.columns);
+    if (chart.columns.empty()) return;
+    
+    double low = chart.columns[0].low;
+    double high = chart.columns[0].high;
+    for (const BalanceRange& column : chart.columns) {
+        low = std::min(low, column.low);
+        high = std::max(high, column.high);
+    }
+    if (high - low < 0.01) {
+        low -= 1.0;
+        high += 1.0;
+    }
+    double pad = (high - low) * 0.05;
+    low -= pad;
+    high += pad;
+    auto toY = [&](double value) {
+        return origin.y + static_cast<float>((high - value) / (high - low)) * size.y;
+    };
+    
+    ImDrawList* draw = ImGui::GetWindowDrawList();
+    ImVec2 corner(origin.x + size.x, origin.y + size.y);
+    draw->AddRectFilled(origin, corner, ImGui::GetColorU32(ImVec4(0.08f, 0.08f, 0.12f, 1.0f)), 6.0f);
+    if (low < 0.0 && high > 0.0) {
+        draw->AddLine(ImVec2(origin.x, toY(0.0)), ImVec2(corner.x, toY(0.0)), ImGui::GetColorU32(ImVec4(1.0f, 0.4f, 0.4f, 0.5f)));
+    }
     
-    // Fallback: if custom font fails, use default with larger size
-    if (font == nullptr) {
-        ImFontConfig config;
-        config.SizePixels = 18.0f;
-        io.Fonts->AddFontDefault(&config);
+    size_t columns = chart.columns.size();
+    float columnWidth = size.x / columns;
+    ImU32 bandColor = ImGui::GetColorU32(ImVec4(0.2f, 0.8f, 1.0f, 0.35f));
+    chart.points.resize(columns);
+    for (size_t i = 0; i < columns; i++) {
+        const BalanceRange& column = chart.columns[i];
+        float x = origin.x + (i + 0.5f) * columnWidth;
+        if (column.high > column.low) {
+            draw->AddLine(ImVec2(x, toY(column.low)), ImVec2(x, toY(column.high)), bandColor, std::max(1.0f, columnWidth));
+        }
+        chart.points[i] = ImVec2(x, toY(column.close));
+    }
+    draw->AddPolyline(chart.points.data(), static_cast<int>(columns), ImGui::GetColorU32(ImVec4(0.2f, 0.8f, 1.0f, 1.0f)), 0, 1.5f);
+    
+    const std::vector<LedgerEntry>& entries = app.ledger.getEntries();
+    if (hovered && !ImGui::IsItemActive()) {
+        size_t column = std::min(columns - 1, static_cast<size_t>(std::max(0.0f, io.MousePos.x - origin.x) / columnWidth));
+        size_t newest = first + (column + 1) * (last - first) / columns - 1;
+        const BalanceRange& range = chart.columns[column];
+        if (range.high > range.low) {
+            ImGui::SetTooltip("%s\nBalance: $%.2f\nRange: $%.2f to $%.2f", formatDate(entries[newest].timestamp).c_str(),
+                              range.close, range.low, range.high);
+        } else {
+            ImGui::SetTooltip("%s\nBalance: $%.2f", formatDate(entries[newest].timestamp).c_str(), range.close);
+        }
     }
     
-    // Don't call Build() - let the backend handle it
+    std::string from = formatDate(entries[first].timestamp);
+    std::string to = formatDate(entries[last - 1].timestamp);
+    ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "%s", from.c_str());
+    ImGui::SameLine(ImGui::GetWindowWidth() - ImGui::GetStyle().WindowPadding.x - ImGui::CalcTextSize(to.c_str()).x);
+    ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "%s", to.c_str());
+}
+
+// Font loading function
+const float FONT_SIZE = 18.0f;
+const std::string FONT_CACHE_FILE = "fonts.cache";
+
+// First font found wins; the Linux entries cover the common distro packages
+const char* const FONT_CANDIDATES[] = {
+    "C:/Windows/Fonts/segoeui.ttf",
+    "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+    "/usr/share/fonts/TTF/DejaVuSans.ttf",
+    "/usr/share/fonts/dejavu/DejaVuSans.ttf",
+    "/usr/share/fonts/truetype/noto/NotoSans-Regular.ttf",
+    "/usr/share/fonts/noto/NotoSans-Regular.ttf",
+    "/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
+    "/usr/share/fonts/liberation-sans/LiberationSans-Regular.ttf",
+};
+
+// Returns true when the atlas came from the on-disk cache
+bool LoadCustomFont(ImGuiIO& io) {
+    // Clear existing fonts first
+    io.Fonts->Clear();
+
+    std::string fontPath;
+    for (const char* candidate : FONT_CANDIDATES) {
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(candidate, ec)) {
+            fontPath = candidate;
+            break;
+        }
+    }
+
+    // A cached atlas skips both reading the TTF and rasterising it
+    if (!fontPath.empty()) {
+        if (loadFontAtlasCache(io.Fonts, FONT_CACHE_FILE, fontPath, FONT_SIZE)) return true;
+        if (io.Fonts->AddFontFromFileTTF(fontPath.c_str(), FONT_SIZE, nullptr, FONT_GLYPH_RANGES) != nullptr) {
+            saveFontAtlasCache(io.Fonts, FONT_CACHE_FILE, fontPath, FONT_SIZE); // Bakes now instead of in the backend
+            return false;
+        }
+        io.Fonts->Clear();
+    }
+
+    // Fallback: if no system font loads, use default with larger size
+    ImFontConfig config;
+    config.SizePixels = FONT_SIZE;
+    io.Fonts->AddFontDefault(&config);
+    return false;
 }
 
 void renderLoginScreen(AppData& app) {
@@ -481,6 +784,33 @@ void renderLoginScreen(AppData& app) {
     ImGui::Separator();
     ImGui::Spacing();
     
+    // Outcome of a login started on an earlier frame
+    if (app.finishLogin()) {
+        switch (app.loginResult) {
+            case LoginResult::SUCCESS:
+                app.invalidateView();
+                app.currentState = AppState::MAIN_MENU;
+                app.dataLoaded = true;
+                app.setStatus("Login successful!", ImVec4(0.0f, 1.0f, 0.0f, 1.0f));
+                break;
+            case LoginResult::READ_ERROR:
+                app.showAlert("Could not read data file!");
+                break;
+            case LoginResult::WRONG_PASSWORD:
+                app.showAlert("Incorrect password!");
+                break;
+            case LoginResult::CORRUPTED:
+                app.showAlert("Data file is corrupted!");
+                break;
+            case LoginResult::JOURNAL_CORRUPTED:
+                app.showAlert("Saved changes (saves.journal) are corrupted!");
+                break;
+            case LoginResult::CANCELLED:
+                app.setStatus("Login cancelled", ImVec4(1.0f, 0.8f, 0.3f, 1.0f));
+                break;
+        }
+    }
+    
     if (!app.fileExists) {
         CenterContent(ImGui::CalcTextSize("Welcome! Create your first account").x);
         ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Welcome! Create your first account");
@@ -508,26 +838,41 @@ void renderLoginScreen(AppData& app) {
                 app.showAlert("Invalid money amount!");
             } else {
                 // Setup new account
-                app.userKey = app.passwordInput;
-                if (app.userKey.length() <= 32) {
-                    app.userKey.append(32 - app.userKey.length(), '*');
-                }
-                
-                app.dataMap = {
-                    {"Total Money", (app.initialMoneyInput.empty() ? "0" : app.initialMoneyInput)},
-                    {"Last Transaction", "-"},
-                    {"Short Note", "-"}
-                };
-
-                app.borrowersMap.clear();
-                app.orderVector = {"Total Money", "Last Transaction", "Short Note"};
+                createAccount(app, app.passwordInput, app.initialMoneyInput.empty() ? "0" : app.initialMoneyInput);
                 
+                app.invalidateView();
                 app.currentState = AppState::MAIN_MENU;
                 app.dataLoaded = true;
                 app.setStatus("Account created successfully!", ImVec4(0.0f, 1.0f, 0.0f, 1.0f));
             }
         }
         ImGui::PopStyleColor(3);
+    } else if (app.loginRunning) {
+        // Loading on the login thread: show how far it got and allow cancelling
+        CenterContent(ImGui::CalcTextSize("Loading your data...").x);
+        ImGui::TextColored(ImVec4(0.0f, 1.0f, 1.0f, 1.0f), "Loading your data...");
+        ImGui::Spacing();
+        
+        uint64_t total = app.loadProgress.bytesTotal;
+        uint64_t decrypted = app.loadProgress.bytesDecrypted;
+        float fraction = total > 0 ? static_cast<float>(static_cast<double>(decrypted) / total) : 0.0f;
+        char overlay[64];
+        std::snprintf(overlay, sizeof(overlay), "%.1f / %.1f MB decrypted", decrypted / 1e6, total / 1e6);
+        ImGui::ProgressBar(fraction, ImVec2(-1, 0), overlay);
+        
+        std::string parsed = std::to_string(app.loadProgress.recordsParsed.load()) + " records parsed";
+        CenterContent(ImGui::CalcTextSize(parsed.c_str()).x);
+        ImGui::Text("%s", parsed.c_str());
+        
+        ImGui::Spacing();
+        CenterContent(100);
+        ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.6f, 0.6f, 0.6f, 1.0f));
+        ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.7f, 0.7f, 0.7f, 1.0f));
+        ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.5f, 0.5f, 0.5f, 1.0f));
+        if (ImGui::Button("Cancel", ImVec2(100, 40))) {
+            app.loadProgress.cancelled = true;
+        }
+        ImGui::PopStyleColor(3);
     } else {
         CenterContent(ImGui::CalcTextSize("Welcome back!").x);
         ImGui::TextColored(ImVec4(0.0f, 1.0f, 1.0f, 1.0f), "Welcome back!");
@@ -546,36 +891,8 @@ void renderLoginScreen(AppData& app) {
             if (!isValidPassword(app.passwordInput)) {
                 app.showAlert("Invalid password!");
             } else {
-                app.userKey = app.passwordInput;
-                if (app.userKey.length() <= 32) {
-                    app.userKey.append(32 - app.userKey.length(), '*');
-                }
-                
-                // Try to load and decrypt data
-                bool readErr = false;
-                std::string saves = loadFile(DATA_FILE, readErr);
-                if (!readErr) {
-                    std::string decrypted = decryptAesCng(saves, app.userKey);
-                    std::string suffix = "valid";
-                    
-                    if (decrypted.size() >= suffix.size() &&
-                        decrypted.compare(decrypted.size() - suffix.size(), suffix.size(), suffix) == 0) {
-                        
-                        decrypted.erase(decrypted.size() - suffix.size());
-                        while (decrypted.back() == '*') {
-                            decrypted.pop_back();
-                        }
-                        
-                        stringToData(decrypted, app.dataMap, app.borrowersMap, app.orderVector);
-                        app.currentState = AppState::MAIN_MENU;
-                        app.dataLoaded = true;
-                        app.setStatus("Login successful!", ImVec4(0.0f, 1.0f, 0.0f, 1.0f));
-                    } else {
-                        app.showAlert("Incorrect password!");
-                    }
-                } else {
-                    app.showAlert("Could not read data file!");
-                }
+                // Verify the password, then decrypt the save and replay the journal off the UI thread
+                app.startLogin();
             }
         }
         ImGui::PopStyleColor(3);
@@ -604,7 +921,7 @@ void renderLoginScreen(AppData& app) {
 }
 
 void renderMainMenu(AppData& app) {
-    CenterWindow(ImVec2(600, 700));
+    CenterWindow(ImVec2(600, 770));
     
     ImGui::Begin("Money Tracker - Main Menu", nullptr, 
         ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize);
@@ -624,26 +941,35 @@ void renderMainMenu(AppData& app) {
     // Quick info panel
     ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.15f, 0.15f, 0.25f, 0.8f));
     ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, 12.0f);
-    ImGui::BeginChild("QuickInfo", ImVec2(0, 120), true);
+    ImGui::BeginChild("QuickInfo", ImVec2(0, 200), true);
     
-    BigNumber totalMoney(app.dataMap["Total Money"]);
+    const DashboardView& view = app.getView();
     ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 10);
-    if (totalMoney.isNegative()) {
-        CenterContent(ImGui::CalcTextSize(("Total Money: $" + totalMoney.toString()).c_str()).x);
-        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Total Money: $%s", totalMoney.toString().c_str());
+    CenterContent(view.totalWidth);
+    if (view.totalNegative) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", view.totalText.c_str());
     } else {
-        CenterContent(ImGui::CalcTextSize(("Total Money: $" + totalMoney.toString()).c_str()).x);
-        ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "Total Money: $%s", totalMoney.toString().c_str());
+        ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "%s", view.totalText.c_str());
     }
     
     ImGui::Spacing();
-    CenterContent(ImGui::CalcTextSize(("Last Transaction: " + app.dataMap["Last Transaction"]).c_str()).x);
-    ImGui::TextColored(ImVec4(0.8f, 0.8f, 0.4f, 1.0f), "Last Transaction: %s", app.dataMap["Last Transaction"].c_str());
+    CenterContent(view.lastTransactionWidth);
+    ImGui::TextColored(ImVec4(0.8f, 0.8f, 0.4f, 1.0f), "%s", view.lastTransactionText.c_str());
     
-    if (app.dataMap["Short Note"] != "-") {
+    ImGui::Spacing();
+    CenterContent(view.loansWidth);
+    ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "%s", view.loansText.c_str());
+    CenterContent(view.netWorthWidth);
+    ImGui::TextColored(ImVec4(0.4f, 0.9f, 1.0f, 1.0f), "%s", view.netWorthText.c_str());
+    if (!view.largestText.empty()) {
+        CenterContent(view.largestWidth);
+        ImGui::TextColored(ImVec4(0.8f, 0.8f, 0.8f, 1.0f), "%s", view.largestText.c_str());
+    }
+    
+    if (view.hasNote) {
         ImGui::Spacing();
-        CenterContent(ImGui::CalcTextSize(("Note: " + app.dataMap["Short Note"]).c_str()).x);
-        ImGui::TextColored(ImVec4(0.7f, 0.7f, 1.0f, 1.0f), "Note: %s", app.dataMap["Short Note"].c_str());
+        CenterContent(view.noteWidth);
+        ImGui::TextColored(ImVec4(0.7f, 0.7f, 1.0f, 1.0f), "%s", view.noteText.c_str());
     }
     ImGui::EndChild();
     ImGui::PopStyleVar();
@@ -694,6 +1020,16 @@ void renderMainMenu(AppData& app) {
     }
     ImGui::PopStyleColor(3);
     
+    CenterContent(buttonSize.x);
+    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.6f, 0.6f, 1.0f));
+    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.7f, 0.7f, 1.0f));
+    ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.1f, 0.5f, 0.5f, 1.0f));
+    if (ImGui::Button("HISTORY", buttonSize)) {
+        if (app.historyDateInput.empty()) app.historyDateInput = formatDate(Ledger::currentTimestamp());
+        app.currentState = AppState::HISTORY;
+    }
+    ImGui::PopStyleColor(3);
+    
     ImGui::PopStyleVar();
     
     ImGui::Spacing();
@@ -708,19 +1044,9 @@ void renderMainMenu(AppData& app) {
     ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.1f, 0.6f, 0.1f, 1.0f));
     if (ImGui::Button("SAVE & EXIT", ImVec2(100, 35))) {
         try {
-            // Save logic here
-            std::string dataString = dataToString(app.dataMap, app.borrowersMap, app.orderVector);
-            int remainder = dataString.length() % 16;
-            if (remainder != 0) {
-                int starCount = 16 - remainder;
-                starCount = (starCount < 5 ? starCount + 11 : starCount - 5);
-                dataString.append(starCount, '*');
-            }
-            dataString += "valid";
-            std::string encrypted = encryptAesCng(dataString, app.userKey);
-            
-            if (!saveToFile(encrypted, DATA_FILE)) {
+            if (saveData(app)) {
                 app.setStatus("Data saved successfully!", ImVec4(0.0f, 1.0f, 0.0f, 1.0f));
+                app.waitForWorker();
                 exit(0);
             } else {
                 app.showAlert("Failed to save data!");
@@ -736,6 +1062,7 @@ void renderMainMenu(AppData& app) {
     ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.8f, 0.6f, 0.3f, 1.0f));
     ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.6f, 0.4f, 0.1f, 1.0f));
     if (ImGui::Button("EXIT ONLY", ImVec2(100, 35))) {
+        app.waitForWorker(); // Never leave a half-written journal record behind
         exit(0);
     }
     ImGui::PopStyleColor(3);
@@ -763,7 +1090,7 @@ void renderMainMenu(AppData& app) {
 }
 
 void renderViewData(AppData& app) {
-    CenterWindow(ImVec2(500, 500));
+    CenterWindow(ImVec2(600, 760));
     
     ImGui::Begin("View Data", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize);
     
@@ -785,22 +1112,35 @@ void renderViewData(AppData& app) {
     
     ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 10);
     
-    BigNumber totalMoney(app.dataMap["Total Money"]);
-    if (totalMoney.isNegative()) {
-        CenterContent(ImGui::CalcTextSize(("Total Money: $" + totalMoney.toString()).c_str()).x);
-        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Total Money: $%s", totalMoney.toString().c_str());
+    const DashboardView& view = app.getView();
+    CenterContent(view.totalWidth);
+    if (view.totalNegative) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", view.totalText.c_str());
     } else {
-        CenterContent(ImGui::CalcTextSize(("Total Money: $" + totalMoney.toString()).c_str()).x);
-        ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "Total Money: $%s", totalMoney.toString().c_str());
+        ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "%s", view.totalText.c_str());
     }
     
     ImGui::Spacing();
-    CenterContent(ImGui::CalcTextSize(("Last Transaction: " + app.dataMap["Last Transaction"]).c_str()).x);
-    ImGui::TextColored(ImVec4(0.8f, 0.8f, 0.4f, 1.0f), "Last Transaction: %s", app.dataMap["Last Transaction"].c_str());
+    CenterContent(view.lastTransactionWidth);
+    ImGui::TextColored(ImVec4(0.8f, 0.8f, 0.4f, 1.0f), "%s", view.lastTransactionText.c_str());
+    
+    ImGui::Spacing();
+    CenterContent(view.shortNoteWidth);
+    ImGui::TextColored(ImVec4(0.7f, 0.7f, 1.0f, 1.0f), "%s", view.shortNoteText.c_str());
+    ImGui::EndChild();
+    ImGui::PopStyleVar();
+    ImGui::PopStyleColor();
     
     ImGui::Spacing();
-    CenterContent(ImGui::CalcTextSize(("Short Note: " + app.dataMap["Short Note"]).c_str()).x);
-    ImGui::TextColored(ImVec4(0.7f, 0.7f, 1.0f, 1.0f), "Short Note: %s", app.dataMap["Short Note"].c_str());
+    
+    // Balance history
+    ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.15f, 0.15f, 0.25f, 0.8f));
+    ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, 12.0f);
+    ImGui::BeginChild("BalanceData", ImVec2(0, 240), true);
+    
+    CenterContent(ImGui::CalcTextSize("BALANCE HISTORY").x);
+    ImGui::TextColored(ImVec4(0.2f, 0.8f, 1.0f, 1.0f), "BALANCE HISTORY");
+    renderBalanceChart(app, 160.0f);
     ImGui::EndChild();
     ImGui::PopStyleVar();
     ImGui::PopStyleColor();
@@ -819,25 +1159,7 @@ void renderViewData(AppData& app) {
     ImGui::Separator();
     ImGui::Spacing();
     
-    if (app.orderVector.size() > 3) {
-        for (size_t i = 3; i < app.orderVector.size(); i++) {
-            std::string name = app.orderVector[i];
-            std::string amount = app.borrowersMap[name];
-            
-            if (amount[0] == '-') {
-                CenterContent(ImGui::CalcTextSize(("[OWES YOU] " + name + ": $" + amount.substr(1)).c_str()).x);
-                ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.6f, 1.0f), "[OWES YOU] %s: $%s", 
-                    name.c_str(), amount.substr(1).c_str());
-            } else {
-                CenterContent(ImGui::CalcTextSize(("[YOU OWE] " + name + ": $" + amount).c_str()).x);
-                ImGui::TextColored(ImVec4(0.6f, 1.0f, 0.6f, 1.0f), "[YOU OWE] %s: $%s", 
-                    name.c_str(), amount.c_str());
-            }
-        }
-    } else {
-        CenterContent(ImGui::CalcTextSize("No borrowers/lenders").x);
-        ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "No borrowers/lenders");
-    }
+    renderBorrowerTable(app, app.dashboardTable, "BorrowersTable", "No borrowers/lenders");
     ImGui::EndChild();
     ImGui::PopStyleVar();
     ImGui::PopStyleColor();
@@ -872,13 +1194,12 @@ void renderTransaction(AppData& app) {
     ImGui::Separator();
     ImGui::Spacing();
     
-    BigNumber currentTotal(app.dataMap["Total Money"]);
-    if (currentTotal.isNegative()) {
-        CenterContent(ImGui::CalcTextSize(("Current Total: $" + currentTotal.toString()).c_str()).x);
-        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Current Total: $%s", currentTotal.toString().c_str());
+    const DashboardView& view = app.getView();
+    CenterContent(view.currentTotalWidth);
+    if (view.totalNegative) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", view.currentTotalText.c_str());
     } else {
-        CenterContent(ImGui::CalcTextSize(("Current Total: $" + currentTotal.toString()).c_str()).x);
-        ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "Current Total: $%s", currentTotal.toString().c_str());
+        ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "%s", view.currentTotalText.c_str());
     }
     
     ImGui::Spacing();
@@ -914,17 +1235,14 @@ void renderTransaction(AppData& app) {
             app.showAlert("Invalid amount (max 50 digits)!");
         } else {
             try {
-                BigNumber currentTotal(app.dataMap["Total Money"]);
-                BigNumber transactionAmount(app.transactionValueInput);
-                
-                if (app.transactionIsPositive) {
-                    app.dataMap["Last Transaction"] = app.transactionValueInput;
-                    app.dataMap["Total Money"] = (currentTotal + transactionAmount).toString();
-                } else {
-                    app.dataMap["Last Transaction"] = "-" + app.transactionValueInput;
-                    app.dataMap["Total Money"] = (currentTotal - transactionAmount).toString();
+                Amount transactionAmount(app.transactionValueInput);
+                if (!app.transactionIsPositive) {
+                    transactionAmount = -transactionAmount;
                 }
                 
+                recordMutation(app, MutationType::TRANSACTION, "", transactionAmount.toString());
+                app.invalidateView(false);
+                
                 app.setStatus("Transaction completed!", ImVec4(0.0f, 1.0f, 0.0f, 1.0f));
                 app.transactionValueInput.clear();
             } catch (const std::exception& e) {
@@ -988,7 +1306,8 @@ void renderNote(AppData& app) {
         if (!isValidNote(app.noteInput)) {
             app.showAlert("Note too long (max 1000 chars)!");
         } else {
-            app.dataMap["Short Note"] = app.noteInput.empty() ? "-" : app.noteInput;
+            recordMutation(app, MutationType::NOTE, "", app.noteInput);
+            app.invalidateView(false);
             app.setStatus("Note saved!", ImVec4(0.0f, 1.0f, 0.0f, 1.0f));
         }
     }
@@ -1036,7 +1355,7 @@ void renderBorrowers(AppData& app) {
     // Current borrowers list
     ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.25f, 0.15f, 0.15f, 0.8f));
     ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, 12.0f);
-    ImGui::BeginChild("CurrentBorrowers", ImVec2(0, 180), true);
+    ImGui::BeginChild("CurrentBorrowers", ImVec2(0, 230), true);
     
     ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 10);
     CenterContent(ImGui::CalcTextSize("Current Records").x);
@@ -1045,25 +1364,12 @@ void renderBorrowers(AppData& app) {
     ImGui::Separator();
     ImGui::Spacing();
     
-    if (app.orderVector.size() > 3) {
-        for (size_t i = 3; i < app.orderVector.size(); i++) {
-            std::string name = app.orderVector[i];
-            std::string amount = app.borrowersMap[name];
-            
-            if (amount[0] == '-') {
-                CenterContent(ImGui::CalcTextSize(("[OWES YOU] " + name + ": $" + amount.substr(1)).c_str()).x);
-                ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.6f, 1.0f), "[OWES YOU] %s: $%s", 
-                    name.c_str(), amount.substr(1).c_str());
-            } else {
-                CenterContent(ImGui::CalcTextSize(("[YOU OWE] " + name + ": $" + amount).c_str()).x);
-                ImGui::TextColored(ImVec4(0.6f, 1.0f, 0.6f, 1.0f), "[YOU OWE] %s: $%s", 
-                    name.c_str(), amount.c_str());
-            }
-        }
-    } else {
-        CenterContent(ImGui::CalcTextSize("No records").x);
-        ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "No records");
+    ImGui::SetNextItemWidth(-1);
+    if (ImGui::InputTextWithHint("##borrowersearch", "Search by name...", &app.borrowerSearchInput)) {
+        app.updateSearch();
     }
+    
+    renderBorrowerTable(app, app.borrowersTable, "CurrentBorrowersTable", "No records", app.getSearchMatches());
     ImGui::EndChild();
     ImGui::PopStyleVar();
     ImGui::PopStyleColor();
@@ -1113,32 +1419,17 @@ void renderBorrowers(AppData& app) {
             app.showAlert("Invalid amount (max 50 digits)!");
         } else {
             try {
-                BigNumber currentTotal(app.dataMap["Total Money"]);
-                BigNumber borrowAmount(app.borrowerValueInput);
+                Amount borrowAmount(app.borrowerValueInput);
                 
-                if (app.borrowerIsYou) {
-                    // You borrowed money (positive for you, you owe them)
-                    if (app.orderVector.size() > 3 && std::find(app.orderVector.begin() + 3, app.orderVector.end(), app.borrowerNameInput) != app.orderVector.end()) {
-                        BigNumber existingAmount(app.borrowersMap[app.borrowerNameInput]);
-                        borrowAmount = existingAmount + borrowAmount;
-                    } else {
-                        app.orderVector.push_back(app.borrowerNameInput);
-                    }
-                    app.borrowersMap[app.borrowerNameInput] = borrowAmount.toString();
-                    app.dataMap["Total Money"] = (currentTotal + BigNumber(app.borrowerValueInput)).toString();
-                } else {
-                    // They borrowed money (negative for them, they owe you)
-                    if (app.orderVector.size() > 3 && std::find(app.orderVector.begin() + 3, app.orderVector.end(), app.borrowerNameInput) != app.orderVector.end()) {
-                        BigNumber existingAmount(app.borrowersMap[app.borrowerNameInput]);
-                        borrowAmount = existingAmount - borrowAmount;
-                        app.borrowersMap[app.borrowerNameInput] = borrowAmount.toString();
-                    } else {
-                        app.borrowersMap[app.borrowerNameInput] = "-" + app.borrowerValueInput;
-                        app.orderVector.push_back(app.borrowerNameInput);
-                    }
-                    app.dataMap["Total Money"] = (currentTotal - BigNumber(app.borrowerValueInput)).toString();
+                // You borrowed money: positive for you, you owe them
+                // They borrowed money: negative for them, they owe you
+                if (!app.borrowerIsYou) {
+                    borrowAmount = -borrowAmount;
                 }
                 
+                recordMutation(app, MutationType::BORROWER, app.borrowerNameInput, borrowAmount.toString());
+                app.invalidateView();
+                
                 app.setStatus("Record added!", ImVec4(0.0f, 1.0f, 0.0f, 1.0f));
                 app.borrowerNameInput.clear();
                 app.borrowerValueInput.clear();
@@ -1172,6 +1463,184 @@ void renderBorrowers(AppData& app) {
     ImGui::End();
 }
 
+// Dates before the entries made since login need the ledger entries login left
+// on disk, unless they fall in a closed year
+bool needsDeferredLedger(const AppData& app, int64_t time) {
+    if (!app.ledgerDeferred || time >= app.deferredLedger.maxTime) return false;
+    return app.segments.empty() || time >= app.segments.back().maxTime;
+}
+
+// Account balance, and the balance of counterparty unless it is NOT_FOUND, after
+// every entry made at or before time. Dates in a closed year load that year's
+// segment file once; later dates are answered from the live ledger index.
+bool balancesAt(AppData& app, int64_t time, uint32_t counterparty, Amount& balance, Amount& counterpartyBalance) {
+    const std::vector<LedgerSegment>& segments = app.segments;
+    if (segments.empty() || time >= segments.back().maxTime) {
+        app.ledgerIndex.sync(app.ledger);
+        balance = app.ledgerIndex.balanceAt(app.ledger, time);
+        if (counterparty != CounterpartyTable::NOT_FOUND) {
+            counterpartyBalance = app.ledgerIndex.counterpartyBalanceAt(counterparty, time, app.counterparties.balanceOf(counterparty));
+        }
+        return true;
+    }
+    
+    size_t index = std::upper_bound(segments.begin(), segments.end(), time,
+        [](int64_t value, const LedgerSegment& segment) { return value < segment.maxTime; }) - segments.begin();
+    if (app.archivedYear != segments[index].year) {
+        app.archivedYear = 0;
+        if (!loadLedgerSegment(app, index, app.archivedLedger, &app.archivedBalances)) return false;
+        app.archivedIndex.sync(app.archivedLedger);
+        app.archivedYear = segments[index].year;
+    }
+    balance = app.archivedIndex.balanceAt(app.archivedLedger, time);
+    if (counterparty != CounterpartyTable::NOT_FOUND) {
+        // Counterparties added after that year had no balance yet
+        Amount closing = counterparty < app.archivedBalances.size() ? app.archivedBalances[counterparty] : Amount();
+        counterpartyBalance = app.archivedIndex.counterpartyBalanceAt(counterparty, time, closing);
+    }
+    return true;
+}
+
+// "name owes you $x" / "name is owed $x", the wording of the dashboard
+std::string describeCounterparty(const std::string& name, const Amount& balance) {
+    if (balance.isZero()) return name + " is settled";
+    return balance.isNegative() ? name + " owes you $" + (-balance).toString() : name + " is owed $" + balance.toString();
+}
+
+// Answer the History screen inputs into app.historyLines
+void runHistoryQuery(AppData& app) {
+    int64_t date = 0;
+    int64_t compare = 0;
+    bool hasCompare = !app.historyCompareInput.empty();
+    if (!parseEndOfDay(app.historyDateInput, date) || (hasCompare && !parseEndOfDay(app.historyCompareInput, compare))) {
+        app.showAlert("Enter dates as YYYY-MM-DD!");
+        return;
+    }
+    uint32_t counterparty = CounterpartyTable::NOT_FOUND;
+    if (!app.historyNameInput.empty()) {
+        counterparty = app.counterparties.find(app.historyNameInput);
+        if (counterparty == CounterpartyTable::NOT_FOUND) {
+            app.showAlert("No borrower/lender with that name!");
+            return;
+        }
+    }
+    
+    if (needsDeferredLedger(app, date) || (hasCompare && needsDeferredLedger(app, compare))) {
+        if (app.ledgerLoadFailed) {
+            app.historyWaiting = false;
+            app.showAlert("Could not read the transaction history!");
+            return;
+        }
+        app.historyWaiting = true;
+        app.historyLines = { "Reading older transactions..." };
+        startLedgerLoad(app); // renderHistory retries while another job runs
+        return;
+    }
+    app.historyWaiting = false;
+    
+    std::vector<std::string> lines;
+    std::string name = app.historyNameInput;
+    Amount balance, owed, compareBalance, compareOwed;
+    if (!balancesAt(app, date, counterparty, balance, owed) ||
+        (hasCompare && !balancesAt(app, compare, counterparty, compareBalance, compareOwed))) {
+        app.showAlert("Could not read the archived history for that date!");
+        return;
+    }
+    
+    lines.push_back("End of " + app.historyDateInput + ": $" + balance.toString());
+    if (counterparty != CounterpartyTable::NOT_FOUND) lines.push_back("  " + describeCounterparty(name, owed));
+    if (hasCompare) {
+        lines.push_back("End of " + app.historyCompareInput + ": $" + compareBalance.toString());
+        if (counterparty != CounterpartyTable::NOT_FOUND) lines.push_back("  " + describeCounterparty(name, compareOwed));
+        
+        // Flows read from the earlier date to the later one
+        bool forward = compare >= date;
+        Amount flow = forward ? compareBalance - balance : balance - compareBalance;
+        lines.push_back("Net flow between the dates: $" + flow.toString());
+        if (counterparty != CounterpartyTable::NOT_FOUND) {
+            Amount counterpartyFlow = forward ? compareOwed - owed : owed - compareOwed;
+            lines.push_back("Net flow with " + name + ": $" + counterpartyFlow.toString());
+        }
+    }
+    app.historyLines = std::move(lines);
+}
+
+void renderHistory(AppData& app) {
+    if (app.historyWaiting) {
+        try {
+            if (!app.ledgerDeferred || app.ledgerLoadFailed) runHistoryQuery(app);
+            else startLedgerLoad(app);
+        } catch (const std::exception& e) {
+            app.historyWaiting = false;
+            app.showAlert("Error reading history!");
+        }
+    }
+    
+    CenterWindow(ImVec2(500, 560));
+    
+    ImGui::Begin("Balance History", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize);
+    
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(8, 12));
+    
+    ImGui::PushFont(ImGui::GetIO().Fonts->Fonts[0]);
+    CenterContent(ImGui::CalcTextSize("BALANCE ON DATE").x);
+    ImGui::TextColored(ImVec4(0.2f, 0.8f, 1.0f, 1.0f), "BALANCE ON DATE");
+    ImGui::PopFont();
+    
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::Spacing();
+    
+    ImGui::Text("Date (YYYY-MM-DD):");
+    ImGui::SetNextItemWidth(-1);
+    InputTextString("##historydate", &app.historyDateInput);
+    
+    ImGui::Text("Compare with date (optional):");
+    ImGui::SetNextItemWidth(-1);
+    InputTextString("##historycompare", &app.historyCompareInput);
+    
+    ImGui::Text("Borrower/lender name (optional):");
+    ImGui::SetNextItemWidth(-1);
+    InputTextString("##historyname", &app.historyNameInput);
+    
+    ImGui::Spacing();
+    CenterContent(220);
+    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.7f, 0.2f, 1.0f));
+    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.8f, 0.3f, 1.0f));
+    ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.1f, 0.6f, 0.1f, 1.0f));
+    if (ImGui::Button("SHOW", ImVec2(120, 35))) {
+        try {
+            runHistoryQuery(app);
+        } catch (const std::exception& e) {
+            app.showAlert("Error reading history!");
+        }
+    }
+    ImGui::PopStyleColor(3);
+    
+    ImGui::SameLine();
+    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.6f, 0.6f, 0.6f, 1.0f));
+    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.7f, 0.7f, 0.7f, 1.0f));
+    ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.5f, 0.5f, 0.5f, 1.0f));
+    if (ImGui::Button("BACK", ImVec2(100, 35))) {
+        app.currentState = AppState::MAIN_MENU;
+    }
+    ImGui::PopStyleColor(3);
+    
+    ImGui::Spacing();
+    ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.15f, 0.15f, 0.25f, 0.8f));
+    ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, 12.0f);
+    ImGui::BeginChild("HistoryResults", ImVec2(0, 0), true);
+    for (const std::string& line : app.historyLines) {
+        ImGui::TextUnformatted(line.c_str());
+    }
+    ImGui::EndChild();
+    ImGui::PopStyleVar();
+    ImGui::PopStyleColor();
+    
+    ImGui::PopStyleVar();
+    ImGui::End();
+}
+
 void renderResetDialog(AppData& app) {
     if (app.showResetDialog) {
         ImGui::OpenPopup("Reset Confirmation");
@@ -1202,6 +1671,13 @@ void renderResetDialog(AppData& app) {
         ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.7f, 0.1f, 0.1f, 1.0f));
         if (ImGui::Button("YES, DELETE EVERYTHING", ImVec2(200, 35))) {
             try {
+                app.waitForWorker();
+                finishSave(app); // Picks up years a finished compaction just closed
+                app.journal.remove();
+                for (const LedgerSegment& segment : app.segments) {
+                    std::error_code ec;
+                    std::filesystem::remove(segmentPath(DATA_FILE, segment.year), ec);
+                }
                 if (std::filesystem::remove(DATA_FILE)) {
                     app.setStatus("All data deleted. Restart the application.", ImVec4(1.0f, 0.0f, 0.0f, 1.0f));
                     exit(0);
@@ -1266,6 +1742,8 @@ void renderErrorAlert(AppData& app) {
 }
 
 int main() {
+    StartupTimer startup;
+
     // Initialize GLFW
     glfwSetErrorCallback(glfw_error_callback);
     if (!glfwInit()) {
@@ -1287,6 +1765,7 @@ int main() {
         glfwTerminate();
         return -1;
     }
+    startup.mark("glfw + window");
     SetGLFWWindowIcon(window);
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1); // Enable vsync
@@ -1306,8 +1785,10 @@ int main() {
     // ADD THIS LINE TO DISABLE .ini FILE:
     io.IniFilename = nullptr;
 
+    startup.mark("gl + imgui");
+
     // Load custom font
-    LoadCustomFont(io);
+    startup.mark(LoadCustomFont(io) ? "font (cached)" : "font (baked)");
 
     // Setup modern style with enhanced colors and professional look
     ImGui::StyleColorsDark();
@@ -1390,38 +1871,38 @@ int main() {
 
     // Application state
     AppData app;
+    app.backgroundDone = []() { glfwPostEmptyEvent(); }; // Wake the idle loop when a worker finishes
     
-    // Check if data file exists
-    try {
-        bool readErr = false;
-        loadFile(DATA_FILE, readErr);
-        app.fileExists = !readErr;
-    } catch (const std::exception& e) {
-        app.fileExists = false;
-    }
+    // Check if data file exists; a stat, so startup does not grow with the save
+    app.fileExists = fileOnDisk(DATA_FILE);
+    startup.mark("style + probe");
 
     // Professional background gradient
     ImVec4 clear_color = ImVec4(0.04f, 0.04f, 0.08f, 1.00f);
 
-    // Main loop
+    // Main loop: draw only after input, a timer or a background job; sleep otherwise
+    int settleFrames = SETTLE_FRAMES;
+    bool startupReported = false;
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        if (settleFrames > 0) {
+            glfwPollEvents();
+            settleFrames--;
+        } else {
+            double wait = app.secondsUntilNextRedraw();
+            if (wait < 0.0) {
+                glfwWaitEvents();
+            } else {
+                glfwWaitEventsTimeout(wait);
+            }
+            settleFrames = SETTLE_FRAMES;
+        }
 
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        // Clear status message after some time (enhanced timing)
-        static int statusCounter = 0;
-        if (!app.statusMessage.empty()) {
-            statusCounter++;
-            if (statusCounter > 240) { // ~4 seconds at 60fps
-                app.statusMessage.clear();
-                statusCounter = 0;
-            }
-        } else {
-            statusCounter = 0;
-        }
+        app.expireStatus();
+        app.autosave();
 
         // Render current screen with enhanced error handling
         try {
@@ -1445,6 +1926,9 @@ int main() {
                 case AppState::BORROWERS:
                     renderBorrowers(app);
                     break;
+                case AppState::HISTORY:
+                    renderHistory(app);
+                    break;
             }
 
             // Handle dialogs
@@ -1466,6 +1950,12 @@ int main() {
         
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
         glfwSwapBuffers(window);
+
+        if (!startupReported) {
+            startup.mark("first frame");
+            startup.report();
+            startupReported = true;
+        }
     }
 
     // Cleanup
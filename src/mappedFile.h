@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read-only memory map of a whole file, so large saves are read straight from
+// the page cache instead of being copied into a heap buffer first.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map path for reading. False when it cannot be opened; an empty file
+    // opens fine and maps to an empty view.
+    bool open(const std::string& path);
+    void close();
+
+    std::string_view view() const { return std::string_view(data, size); }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+};
@@ -0,0 +1,184 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "bigNumber.h"
+
+// Fixed-point money amount with Scale decimal places.
+// Values are kept as a plain int64 count of 10^-Scale units; an amount that overflows
+// int64, or that has more significant decimals than Scale, is promoted to BigNumber.
+template <unsigned Scale>
+class Money {
+private:
+    static_assert(Scale <= 18, "Money scale must fit in int64");
+
+    int64_t units;
+    bool promoted;
+    BigNumber big;
+
+    static bool addOverflow(int64_t a, int64_t b, int64_t* out) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_add_overflow(a, b, out);
+#else
+        if ((b > 0 && a > std::numeric_limits<int64_t>::max() - b) ||
+            (b < 0 && a < std::numeric_limits<int64_t>::min() - b)) return true;
+        *out = a + b;
+        return false;
+#endif
+    }
+
+    static bool subOverflow(int64_t a, int64_t b, int64_t* out) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_sub_overflow(a, b, out);
+#else
+        if ((b < 0 && a > std::numeric_limits<int64_t>::max() + b) ||
+            (b > 0 && a < std::numeric_limits<int64_t>::min() + b)) return true;
+        *out = a - b;
+        return false;
+#endif
+    }
+
+    // Parse into units; returns false when the value does not fit the fast path
+    static bool parseUnits(const std::string& str, int64_t& out) {
+        size_t i = (!str.empty() && str[0] == '-') ? 1 : 0;
+        bool neg = (i == 1);
+        // Accumulate as a negative number so INT64_MIN is representable
+        int64_t acc = 0;
+        unsigned fracDigits = 0;
+        bool seenDecimal = false;
+
+        for (; i < str.size(); i++) {
+            char c = str[i];
+            if (c == '.') {
+                if (seenDecimal) return false;
+                seenDecimal = true;
+                continue;
+            }
+            if (c < '0' || c > '9') return false;
+            if (seenDecimal && fracDigits == Scale) {
+                // Extra decimals are fine as long as they are zeros
+                if (c != '0') return false;
+                continue;
+            }
+            if (seenDecimal) fracDigits++;
+            if (acc < std::numeric_limits<int64_t>::min() / 10) return false;
+            acc *= 10;
+            if (subOverflow(acc, c - '0', &acc)) return false;
+        }
+        for (; fracDigits < Scale; fracDigits++) {
+            if (acc < std::numeric_limits<int64_t>::min() / 10) return false;
+            acc *= 10;
+        }
+
+        if (neg) {
+            out = acc;
+        } else {
+            if (acc == std::numeric_limits<int64_t>::min()) return false;
+            out = -acc;
+        }
+        return true;
+    }
+
+    static std::string formatUnits(int64_t value) {
+        uint64_t magnitude = value < 0 ? 0ull - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        std::string digits = std::to_string(magnitude);
+        if (Scale > 0) {
+            if (digits.size() <= Scale) digits.insert(0, Scale - digits.size() + 1, '0');
+            digits.insert(digits.size() - Scale, 1, '.');
+            // Remove trailing zeros from fractional part
+            while (digits.back() == '0') digits.pop_back();
+            if (digits.back() == '.') digits.pop_back();
+        }
+        if (value < 0) digits.insert(0, 1, '-');
+        return digits;
+    }
+
+    void promote() {
+        if (promoted) return;
+        big = BigNumber(formatUnits(units));
+        units = 0;
+        promoted = true;
+    }
+
+    BigNumber asBig() const {
+        return promoted ? big : BigNumber(formatUnits(units));
+    }
+
+public:
+    Money() : units(0), promoted(false) {}
+
+    Money(const std::string& str) : units(0), promoted(false) {
+        if (!parseUnits(str, units)) {
+            // Also covers malformed input, which BigNumber turns into zero
+            units = 0;
+            big = BigNumber(str);
+            promoted = true;
+        }
+    }
+
+    Money(const BigNumber& value) : Money(value.toString()) {}
+
+    static Money fromUnits(int64_t value) {
+        Money m;
+        m.units = value;
+        return m;
+    }
+
+    std::string toString() const {
+        return promoted ? big.toString() : formatUnits(units);
+    }
+
+    // True while the value lives in the int64 fast path
+    bool isFast() const { return !promoted; }
+    int64_t rawUnits() const { return units; }
+
+    bool isZero() const { return promoted ? big.isZero() : units == 0; }
+    bool isNegative() const { return promoted ? big.isNegative() : units < 0; }
+
+    int compare(const Money& other) const {
+        if (!promoted && !other.promoted) return (units > other.units) - (units < other.units);
+        return asBig().compare(other.asBig());
+    }
+
+    Money& operator+=(const Money& other) {
+        int64_t result;
+        if (!promoted && !other.promoted && !addOverflow(units, other.units, &result)) {
+            units = result;
+            return *this;
+        }
+        promote();
+        big += other.asBig();
+        return *this;
+    }
+
+    Money& operator-=(const Money& other) {
+        int64_t result;
+        if (!promoted && !other.promoted && !subOverflow(units, other.units, &result)) {
+            units = result;
+            return *this;
+        }
+        promote();
+        big -= other.asBig();
+        return *this;
+    }
+
+    Money operator+(const Money& other) const {
+        Money result = *this;
+        result += other;
+        return result;
+    }
+
+    Money operator-(const Money& other) const {
+        Money result = *this;
+        result -= other;
+        return result;
+    }
+
+    Money operator-() const {
+        return Money() - *this;
+    }
+};
+
+// Cent precision covers every amount the UI accepts without promotion in practice
+using Amount = Money<2>;
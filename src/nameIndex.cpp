@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cctype>
+#include <numeric>
+
+#include "nameIndex.h"
+
+std::string lowercase(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(),
+        [](unsigned char c) { return std::tolower(c); });
+    return str;
+}
+
+bool NameIndex::keyLess(uint32_t a, uint32_t b) const {
+    int order = keys[a].compare(keys[b]);
+    return order < 0 || (order == 0 && a < b);
+}
+
+void NameIndex::sync(const CounterpartyTable& counterparties) {
+    if (counterparties.size() < keys.size()) clear();
+
+    uint32_t firstNew = static_cast<uint32_t>(keys.size());
+    uint32_t end = static_cast<uint32_t>(counterparties.size());
+    if (firstNew == end) return;
+
+    keys.reserve(end);
+    for (uint32_t id = firstNew; id < end; id++) {
+        keys.push_back(lowercase(counterparties.nameOf(id)));
+    }
+
+    auto less = [this](uint32_t a, uint32_t b) { return keyLess(a, b); };
+    if (end - firstNew <= INSERT_LIMIT) {
+        // A few live additions: one binary search and memmove each
+        for (uint32_t id = firstNew; id < end; id++) {
+            sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), id, less), id);
+        }
+    } else {
+        // Bulk load: sort only the new ids, then merge with the existing run
+        size_t middle = sorted.size();
+        sorted.resize(end);
+        std::iota(sorted.begin() + middle, sorted.end(), firstNew);
+        std::sort(sorted.begin() + middle, sorted.end(), less);
+        std::inplace_merge(sorted.begin(), sorted.begin() + middle, sorted.end(), less);
+    }
+}
+
+void NameIndex::clear() {
+    keys.clear();
+    sorted.clear();
+}
+
+NameIndex::Matches NameIndex::search(std::string_view query) const {
+    std::string prefix = lowercase(std::string(query));
+
+    // Keys starting with prefix are exactly those that compare equal on their first prefix.size() chars
+    auto first = std::lower_bound(sorted.begin(), sorted.end(), prefix,
+        [this](uint32_t id, const std::string& p) { return keys[id].compare(0, p.size(), p) < 0; });
+    auto last = std::upper_bound(first, sorted.end(), prefix,
+        [this](const std::string& p, uint32_t id) { return keys[id].compare(0, p.size(), p) > 0; });
+
+    Matches matches;
+    matches.ids = sorted.data() + (first - sorted.begin());
+    matches.count = static_cast<size_t>(last - first);
+    return matches;
+}
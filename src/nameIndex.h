@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "counterparties.h"
+
+// Normalised form used for case-insensitive matching
+std::string lowercase(std::string str);
+
+// Case-insensitive prefix search over counterparty names. Lowercased names are
+// kept once per id and the ids are sorted by them, so a query is two binary
+// searches and every match sits in one contiguous run of the sorted array.
+class NameIndex {
+public:
+    // Matching ids in name order. Points into the index, so it is only valid
+    // until the next sync() or clear().
+    struct Matches {
+        const uint32_t* ids = nullptr;
+        size_t count = 0;
+    };
+
+    // Index the counterparties added since the last call. Ids are append-only;
+    // a table that shrank (new login) is indexed again from scratch.
+    void sync(const CounterpartyTable& counterparties);
+
+    void clear();
+    size_t size() const { return keys.size(); }
+
+    // Every id whose name starts with query, ignoring case
+    Matches search(std::string_view query) const;
+
+private:
+    // Below this many new names each one is inserted in place, above it the
+    // new ids are sorted on their own and merged in
+    static constexpr size_t INSERT_LIMIT = 64;
+
+    std::vector<std::string> keys;  // lowercase(name), indexed by id
+    std::vector<uint32_t> sorted;   // Ids ordered by key, then by id
+
+    bool keyLess(uint32_t a, uint32_t b) const;
+};
@@ -1,8 +1,55 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <filesystem>
 #include <map>
 #include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+#include "savingFunctions.h"
+#include "blockContainer.h"
+#include "counterparties.h"
+#include "ledger.h"
+
+namespace {
+    // Fixed keys that lead the stored order list, ahead of the counterparty names
+    const char* const DATA_KEYS[] = { "Total Money", "Last Transaction", "Short Note" };
+
+    // Counterparties are stored as name/balance pairs plus a separate order list.
+    // Rebuild the table so ids follow that order; pairs missing from it go last.
+    void orderCounterparties(CounterpartyTable& byName, const std::vector<std::string_view>& order, CounterpartyTable& out) {
+        // Saves written from a CounterpartyTable already list the pairs in id order
+        if (order.size() >= byName.size()) {
+            size_t offset = order.size() - byName.size();
+            bool inOrder = true;
+            for (uint32_t id = 0; id < byName.size() && inOrder; id++) {
+                inOrder = (order[offset + id] == byName.nameOf(id));
+            }
+            if (inOrder) {
+                out = std::move(byName);
+                return;
+            }
+        }
+
+        out.clear();
+        out.reserve(byName.size());
+        for (std::string_view name : order) {
+            uint32_t id = byName.find(name);
+            if (id != CounterpartyTable::NOT_FOUND) {
+                out.setBalance(out.findOrAdd(name), byName.balanceOf(id));
+            }
+        }
+        for (uint32_t id = 0; id < byName.size() && out.size() < byName.size(); id++) {
+            if (out.find(byName.nameOf(id)) == CounterpartyTable::NOT_FOUND) {
+                out.setBalance(out.findOrAdd(byName.nameOf(id)), byName.balanceOf(id));
+            }
+        }
+    }
+}
 
 std::string loadFile(const std::string& filename, bool& err) {
     std::ifstream file(filename, std::ios::binary);
@@ -30,6 +77,12 @@ std::string loadFile(const std::string& filename, bool& err) {
 }
 
 
+bool fileOnDisk(const std::string& filename) {
+    std::error_code ec;
+    return std::filesystem::is_regular_file(filename, ec);
+}
+
+
 bool saveToFile(const std::string& dataString, const std::string& filename) {
     std::ofstream file(filename, std::ios::binary);
     if (file.is_open()) {
@@ -44,7 +97,7 @@ bool saveToFile(const std::string& dataString, const std::string& filename) {
 
 
 
-std::string dataToString(const std::map<std::string, std::string>& dataMap, const std::map<std::string, std::string>& borrowersMap, const std::vector<std::string>& orderVector) {
+std::string dataToString(const std::map<std::string, std::string>& dataMap, const CounterpartyTable& counterparties) {
 
     std::string result;
     for (const auto& pair : dataMap) {
@@ -53,29 +106,33 @@ std::string dataToString(const std::map<std::string, std::string>& dataMap, cons
     if (!result.empty()) result.pop_back();
 
     result.push_back('|');
-    for (const auto& pair : borrowersMap) {
-        result += pair.first + ":" + pair.second + ",";
+    for (uint32_t id = 0; id < counterparties.size(); id++) {
+        result += counterparties.nameOf(id) + ":" + counterparties.balanceOf(id).toString() + ",";
     }
     if (result.back() != '|') result.pop_back();
 
     result.push_back('|');
     size_t totalSize = result.size();
-    for (const auto& item : orderVector) {
-        totalSize += item.size() + 1;
+    for (uint32_t id = 0; id < counterparties.size(); id++) {
+        totalSize += counterparties.nameOf(id).size() + 1;
     }
 
-    result.reserve(totalSize);
+    result.reserve(totalSize + 48);
 
-    for (size_t i = 0; i < orderVector.size(); ++i) {
-        result += orderVector[i];
+    for (const char* key : DATA_KEYS) {
+        result += key;
         result.push_back(',');
     }
-    if (!result.empty()) result.pop_back();
+    for (uint32_t id = 0; id < counterparties.size(); id++) {
+        result += counterparties.nameOf(id);
+        result.push_back(',');
+    }
+    result.pop_back();
 
     return result;
 }
 
-void stringToData(const std::string_view data, std::map<std::string, std::string>& outDataMap, std::map<std::string, std::string>& outBorrowersMap, std::vector<std::string>& outOrderVector) {
+void stringToData(const std::string_view data, std::map<std::string, std::string>& outDataMap, CounterpartyTable& outCounterparties) {
 
     size_t first = data.find('|');
     size_t second = data.find('|', first + 1);
@@ -99,6 +156,7 @@ void stringToData(const std::string_view data, std::map<std::string, std::string
             start = end + 1;
         }
     }
+    CounterpartyTable byName;
     start = 0;
     {
         while (start < borrowersMapString.size()) {
@@ -108,20 +166,599 @@ void stringToData(const std::string_view data, std::map<std::string, std::string
             std::string_view pair = borrowersMapString.substr(start, end - start);
             size_t colon = pair.find(':');
             if (colon != std::string_view::npos) {
-                outBorrowersMap[std::string(pair.substr(0, colon))] = std::string(pair.substr(colon + 1));
+                byName.setBalance(byName.findOrAdd(pair.substr(0, colon)), Amount(std::string(pair.substr(colon + 1))));
             }
 
             start = end + 1;
         }
     }
+    std::vector<std::string_view> order;
     start = 0;
     {
         while (start < orderVectorString.size()) {
             size_t end = orderVectorString.find(',', start);
             if (end == std::string_view::npos) end = orderVectorString.size();
-            outOrderVector.push_back(std::string(orderVectorString.substr(start, end - start)));
+            order.push_back(orderVectorString.substr(start, end - start));
 
             start = end + 1;
         }
     }
-}
\ No newline at end of file
+    orderCounterparties(byName, order, outCounterparties);
+}
+
+
+// ------------------------------
+// Binary save format
+// ------------------------------
+// [SaveHeader][section]...  where each section is [uint32 tag][uint64 length][payload].
+// Strings are [uint32 length][bytes], integers are little-endian. Readers skip
+// sections with unknown tags, so new optional sections can be added without a
+// version bump. A header version above SAVE_VERSION marks an incompatible
+// change and is rejected.
+
+namespace {
+    const char SAVE_MAGIC[4] = { 'M', 'T', 'S', 'V' };
+    const uint32_t PROGRESS_RECORDS = 4096; // Counterparties parsed between progress updates
+    const uint16_t SAVE_VERSION = 1;
+
+    enum SectionTag : uint32_t {
+        SECTION_DATA = 1,
+        SECTION_BORROWERS = 2,
+        SECTION_ORDER = 3,
+        SECTION_LEDGER = 4,
+        SECTION_META = 5
+    };
+
+    struct SaveHeader {
+        char magic[4];
+        uint16_t version;
+        uint16_t sectionCount;
+        uint64_t payloadSize;  // Whole save including this header, excludes encryption padding
+    };
+
+    static_assert(sizeof(SaveHeader) == 16, "SaveHeader must stay 16 bytes");
+
+    template <typename T>
+    void putInt(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void putString(std::string& out, const std::string& value) {
+        putInt<uint32_t>(out, static_cast<uint32_t>(value.size()));
+        out.append(value);
+    }
+
+    // Reserve a section header and return its offset so the length can be patched in later
+    size_t beginSection(std::string& out, SectionTag tag) {
+        putInt<uint32_t>(out, tag);
+        size_t at = out.size();
+        putInt<uint64_t>(out, 0);
+        return at;
+    }
+
+    void endSection(std::string& out, size_t at) {
+        uint64_t length = out.size() - at - sizeof(uint64_t);
+        std::memcpy(&out[at], &length, sizeof(length));
+    }
+
+    void putMap(std::string& out, const std::map<std::string, std::string>& map) {
+        putInt<uint32_t>(out, static_cast<uint32_t>(map.size()));
+        for (const auto& pair : map) {
+            putString(out, pair.first);
+            putString(out, pair.second);
+        }
+    }
+
+    size_t mapBytes(const std::map<std::string, std::string>& map) {
+        size_t total = sizeof(uint32_t);
+        for (const auto& pair : map) {
+            total += 2 * sizeof(uint32_t) + pair.first.size() + pair.second.size();
+        }
+        return total;
+    }
+
+    // Bounds-checked sequential reader over the save bytes
+    struct Reader {
+        const char* cursor;
+        const char* end;
+
+        template <typename T>
+        bool getInt(T& value) {
+            if (static_cast<size_t>(end - cursor) < sizeof(T)) return false;
+            std::memcpy(&value, cursor, sizeof(T));
+            cursor += sizeof(T);
+            return true;
+        }
+
+        bool getString(std::string_view& value) {
+            uint32_t length;
+            if (!getInt(length) || static_cast<size_t>(end - cursor) < length) return false;
+            value = std::string_view(cursor, length);
+            cursor += length;
+            return true;
+        }
+    };
+
+    bool readMap(Reader& reader, std::map<std::string, std::string>& outMap) {
+        uint32_t count;
+        if (!reader.getInt(count)) return false;
+        for (uint32_t i = 0; i < count; i++) {
+            std::string_view key, value;
+            if (!reader.getString(key) || !reader.getString(value)) return false;
+            // Keys were written in map order, so appending at end() is amortised O(1)
+            outMap.emplace_hint(outMap.end(), std::string(key), std::string(value));
+        }
+        return true;
+    }
+}
+
+bool isBinarySave(const std::string_view data) {
+    return data.size() >= sizeof(SaveHeader) && std::memcmp(data.data(), SAVE_MAGIC, sizeof(SAVE_MAGIC)) == 0;
+}
+
+std::string dataToBinary(const std::map<std::string, std::string>& dataMap, const CounterpartyTable& counterparties, const Ledger& ledger, uint64_t journalSequence) {
+
+    size_t totalSize = sizeof(SaveHeader) + 5 * (sizeof(uint32_t) + sizeof(uint64_t)) + sizeof(uint64_t);
+    totalSize += mapBytes(dataMap) + 2 * sizeof(uint32_t) + 64;
+    for (uint32_t id = 0; id < counterparties.size(); id++) {
+        // Name twice (pairs and order list) plus a formatted balance
+        totalSize += 3 * sizeof(uint32_t) + 2 * counterparties.nameOf(id).size() + 24;
+    }
+    totalSize += ledger.size() * sizeof(LedgerEntry);
+
+    std::string result;
+    result.reserve(totalSize);
+
+    SaveHeader header;
+    std::memcpy(header.magic, SAVE_MAGIC, sizeof(SAVE_MAGIC));
+    header.version = SAVE_VERSION;
+    header.sectionCount = 5;
+    header.payloadSize = 0;
+    result.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    size_t at = beginSection(result, SECTION_META);
+    putInt<uint64_t>(result, journalSequence);
+    endSection(result, at);
+
+    at = beginSection(result, SECTION_DATA);
+    putMap(result, dataMap);
+    endSection(result, at);
+
+    // Pairs are written in id order; readers rebuild ids from SECTION_ORDER
+    at = beginSection(result, SECTION_BORROWERS);
+    putInt<uint32_t>(result, static_cast<uint32_t>(counterparties.size()));
+    for (uint32_t id = 0; id < counterparties.size(); id++) {
+        putString(result, counterparties.nameOf(id));
+        putString(result, counterparties.balanceOf(id).toString());
+    }
+    endSection(result, at);
+
+    at = beginSection(result, SECTION_ORDER);
+    putInt<uint32_t>(result, static_cast<uint32_t>(std::size(DATA_KEYS) + counterparties.size()));
+    for (const char* key : DATA_KEYS) {
+        putString(result, key);
+    }
+    for (uint32_t id = 0; id < counterparties.size(); id++) {
+        putString(result, counterparties.nameOf(id));
+    }
+    endSection(result, at);
+
+    at = beginSection(result, SECTION_LEDGER);
+    ledger.appendTo(result);
+    endSection(result, at);
+
+    uint64_t payloadSize = result.size();
+    std::memcpy(&result[offsetof(SaveHeader, payloadSize)], &payloadSize, sizeof(payloadSize));
+    return result;
+}
+
+bool binaryToData(const std::string_view data, std::map<std::string, std::string>& outDataMap, CounterpartyTable& outCounterparties, Ledger& outLedger, uint64_t* outJournalSequence, LoadProgress* progress) {
+    if (!isBinarySave(data)) return false;
+
+    SaveHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.version > SAVE_VERSION || header.payloadSize < sizeof(header) || header.payloadSize > data.size()) return false;
+
+    // Anything past payloadSize is encryption padding
+    Reader reader{ data.data() + sizeof(header), data.data() + header.payloadSize };
+    bool hasLedger = false;
+    CounterpartyTable byName;
+    std::vector<std::string_view> order;
+
+    for (uint16_t i = 0; i < header.sectionCount; i++) {
+        uint32_t tag;
+        uint64_t length;
+        if (!reader.getInt(tag) || !reader.getInt(length) || length > static_cast<uint64_t>(reader.end - reader.cursor)) return false;
+
+        Reader section{ reader.cursor, reader.cursor + length };
+        reader.cursor += length;
+
+        switch (tag) {
+            case SECTION_META: {
+                uint64_t journalSequence;
+                if (!section.getInt(journalSequence)) return false;
+                if (outJournalSequence) *outJournalSequence = journalSequence;
+                break;
+            }
+            case SECTION_DATA:
+                if (!readMap(section, outDataMap)) return false;
+                break;
+            case SECTION_BORROWERS: {
+                uint32_t count;
+                if (!section.getInt(count)) return false;
+                byName.reserve(count);
+                for (uint32_t j = 0; j < count; j++) {
+                    std::string_view name, balance;
+                    if (!section.getString(name) || !section.getString(balance)) return false;
+                    byName.setBalance(byName.findOrAdd(name), Amount(std::string(balance)));
+                    if (progress && (j + 1) % PROGRESS_RECORDS == 0) {
+                        progress->recordsParsed += PROGRESS_RECORDS;
+                        if (progress->cancelled) return false;
+                    }
+                }
+                if (progress) progress->recordsParsed += count % PROGRESS_RECORDS;
+                break;
+            }
+            case SECTION_ORDER: {
+                uint32_t count;
+                if (!section.getInt(count)) return false;
+                order.reserve(count);
+                for (uint32_t j = 0; j < count; j++) {
+                    std::string_view item;
+                    if (!section.getString(item)) return false;
+                    order.push_back(item);
+                }
+                break;
+            }
+            case SECTION_LEDGER:
+                if (outLedger.loadFrom(std::string_view(section.cursor, length)) != 0) return false;
+                if (progress) progress->recordsParsed += outLedger.size();
+                hasLedger = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    orderCounterparties(byName, order, outCounterparties);
+    if (!hasLedger) {
+        outLedger.reset(Amount(outDataMap["Total Money"]));
+    }
+    return true;
+}
+
+bool loadSaveData(const std::string_view data, std::map<std::string, std::string>& outDataMap, CounterpartyTable& outCounterparties, Ledger& outLedger, uint64_t* outJournalSequence, LoadProgress* progress) {
+    if (outJournalSequence) *outJournalSequence = 0;
+    if (isBinarySave(data)) {
+        return binaryToData(data, outDataMap, outCounterparties, outLedger, outJournalSequence, progress);
+    }
+
+    // Legacy text save: strip the '*' padding, then an optional trailing ledger block
+    std::string_view text = data;
+    while (!text.empty() && text.back() == '*') {
+        text.remove_suffix(1);
+    }
+
+    size_t textSize = outLedger.loadFrom(text);
+    stringToData(text.substr(0, textSize), outDataMap, outCounterparties);
+    if (textSize == text.size()) {
+        // Saves from before the ledger existed start their history at the stored total
+        outLedger.reset(Amount(outDataMap["Total Money"]));
+    }
+    if (progress) {
+        // The text format parses in one pass, so it reports once at the end
+        progress->recordsParsed += outCounterparties.size() + outLedger.size();
+        if (progress->cancelled) return false;
+    }
+    return true;
+}
+
+
+// ------------------------------
+// Block save layout
+// ------------------------------
+// One summary block with everything the dashboard shows, counterparty pages in
+// id order ([name][balance] strings), ledger blocks of raw LedgerEntry records
+// in entry order, one block holding the ledger text pool, the last activity of
+// every counterparty and the list of closed years kept in segment files. The
+// index records the first id / entry and count of every page and the timestamp
+// range of every ledger block, so a view can decrypt just the blocks it needs.
+// Segment files use the same container: a checkpoint block plus ledger blocks.
+
+namespace {
+    enum BlockKind : uint32_t {
+        BLOCK_SUMMARY = 1,
+        BLOCK_COUNTERPARTIES = 2,
+        BLOCK_LEDGER = 3,
+        BLOCK_LEDGER_TEXT = 4,
+        BLOCK_ACTIVITY = 5,   // int64 last activity per counterparty id
+        BLOCK_SEGMENTS = 6,   // Closed years stored in segment files
+        BLOCK_CHECKPOINT = 7  // Segment files only: the period and balances at its end
+    };
+
+    const size_t COUNTERPARTY_PAGE = 4096;     // Counterparties per page
+    const size_t LEDGER_BLOCK_ENTRIES = 32768; // 1 MiB of entries per ledger block
+
+    bool readSummary(std::string_view block, SaveSummary& out) {
+        Reader reader{ block.data(), block.data() + block.size() };
+        std::string_view opening, balance, owedToYou, youOwe, largestName, largestBalance;
+        uint64_t owingYouCount, youOweCount;
+        if (!reader.getInt(out.journalSequence) || !readMap(reader, out.dataMap) ||
+            !reader.getInt(out.counterpartyCount) || !reader.getInt(out.ledgerEntries) ||
+            !reader.getString(opening) || !reader.getString(balance) ||
+            !reader.getString(owedToYou) || !reader.getString(youOwe) ||
+            !reader.getInt(owingYouCount) || !reader.getInt(youOweCount) ||
+            !reader.getString(largestName) || !reader.getString(largestBalance)) return false;
+
+        out.openingBalance = Amount(std::string(opening));
+        out.balance = Amount(std::string(balance));
+        out.totals.owedToYou = Amount(std::string(owedToYou));
+        out.totals.youOwe = Amount(std::string(youOwe));
+        out.totals.owingYouCount = static_cast<size_t>(owingYouCount);
+        out.totals.youOweCount = static_cast<size_t>(youOweCount);
+        out.largestName = std::string(largestName);
+        out.largestBalance = Amount(std::string(largestBalance));
+        return true;
+    }
+
+    void putSegment(std::string& out, const LedgerSegment& segment) {
+        putInt<int32_t>(out, segment.year);
+        putInt<uint64_t>(out, segment.entryCount);
+        putInt<int64_t>(out, segment.minTime);
+        putInt<int64_t>(out, segment.maxTime);
+        putString(out, segment.openingBalance.toString());
+        putString(out, segment.closingBalance.toString());
+    }
+
+    bool readSegment(Reader& reader, LedgerSegment& out) {
+        std::string_view opening, closing;
+        if (!reader.getInt(out.year) || !reader.getInt(out.entryCount) || !reader.getInt(out.minTime) ||
+            !reader.getInt(out.maxTime) || !reader.getString(opening) || !reader.getString(closing)) return false;
+        out.openingBalance = Amount(std::string(opening));
+        out.closingBalance = Amount(std::string(closing));
+        return true;
+    }
+
+    // Blocks of one kind sorted by first record; false unless they cover [0, total) without gaps
+    bool collectRun(const std::vector<BlockInfo>& blocks, BlockKind kind, uint64_t total, std::vector<size_t>& out) {
+        for (size_t i = 0; i < blocks.size(); i++) {
+            if (blocks[i].kind == kind) out.push_back(i);
+        }
+        std::sort(out.begin(), out.end(), [&](size_t a, size_t b) { return blocks[a].first < blocks[b].first; });
+        uint64_t next = 0;
+        for (size_t i : out) {
+            if (blocks[i].first != next || blocks[i].count > total - next) return false;
+            next += blocks[i].count;
+        }
+        return next == total;
+    }
+
+    size_t findBlock(const std::vector<BlockInfo>& blocks, BlockKind kind) {
+        for (size_t i = 0; i < blocks.size(); i++) {
+            if (blocks[i].kind == kind) return i;
+        }
+        return blocks.size();
+    }
+
+    void addLedgerBlocks(BlockWriter& writer, const Ledger& ledger) {
+        const std::vector<LedgerEntry>& entries = ledger.getEntries();
+        for (size_t first = 0; first < entries.size(); first += LEDGER_BLOCK_ENTRIES) {
+            size_t count = std::min(LEDGER_BLOCK_ENTRIES, entries.size() - first);
+            int64_t minTime = entries[first].timestamp, maxTime = entries[first].timestamp;
+            for (size_t i = first; i < first + count; i++) {
+                minTime = std::min(minTime, entries[i].timestamp);
+                maxTime = std::max(maxTime, entries[i].timestamp);
+            }
+            writer.add(BlockInfo{ BLOCK_LEDGER, 0, 0, 0, first, count, minTime, maxTime },
+                       std::string(reinterpret_cast<const char*>(&entries[first]), count * sizeof(LedgerEntry)));
+        }
+        writer.add(BlockInfo{ BLOCK_LEDGER_TEXT, 0, 0, 0, 0, 1, 0, 0 }, std::string(ledger.getTextPool()));
+    }
+
+    // Ledger blocks decrypt straight into one entry array; extra targets ride along in the same parallel pass
+    bool readLedgerBlocks(const BlockReader& reader, uint64_t entryCount, const Amount& opening, const Amount& balance,
+                          Ledger& outLedger, std::vector<BlockReader::Target> targets, LoadProgress* progress) {
+        const std::vector<BlockInfo>& blocks = reader.blocks();
+        std::vector<size_t> ledgerBlocks;
+        size_t textBlock = findBlock(blocks, BLOCK_LEDGER_TEXT);
+        if (textBlock == blocks.size() || !collectRun(blocks, BLOCK_LEDGER, entryCount, ledgerBlocks)) return false;
+        for (size_t i : ledgerBlocks) {
+            if (blocks[i].size != blocks[i].count * sizeof(LedgerEntry)) return false;
+        }
+
+        std::vector<LedgerEntry> entries(static_cast<size_t>(entryCount));
+        for (size_t i : ledgerBlocks) {
+            targets.push_back({ i, entries.data() + blocks[i].first });
+        }
+        std::string textPool(static_cast<size_t>(blocks[textBlock].size), '\0');
+        targets.push_back({ textBlock, &textPool[0] });
+        if (!reader.readInto(targets, 0, progress ? &progress->bytesDecrypted : nullptr,
+                             progress ? &progress->cancelled : nullptr)) return false;
+
+        outLedger.restore(std::move(entries), std::move(textPool), opening, balance);
+        return true;
+    }
+}
+
+std::string dataToBlocks(const std::map<std::string, std::string>& dataMap, const CounterpartyTable& counterparties, const Ledger& ledger, const std::vector<LedgerSegment>& segments, uint64_t journalSequence, const CryptoSession& crypto) {
+    BlockWriter writer;
+
+    std::string summary;
+    putInt<uint64_t>(summary, journalSequence);
+    putMap(summary, dataMap);
+    putInt<uint64_t>(summary, counterparties.size());
+    putInt<uint64_t>(summary, ledger.size());
+    putString(summary, ledger.getOpeningBalance().toString());
+    putString(summary, ledger.getBalance().toString());
+    const CounterpartyTotals& totals = counterparties.totals();
+    putString(summary, totals.owedToYou.toString());
+    putString(summary, totals.youOwe.toString());
+    putInt<uint64_t>(summary, totals.owingYouCount);
+    putInt<uint64_t>(summary, totals.youOweCount);
+    uint32_t largest = counterparties.largestExposure();
+    putString(summary, largest == CounterpartyTable::NOT_FOUND ? "" : counterparties.nameOf(largest));
+    putString(summary, largest == CounterpartyTable::NOT_FOUND ? "0" : counterparties.balanceOf(largest).toString());
+    writer.add(BlockInfo{ BLOCK_SUMMARY, 0, 0, 0, 0, 1, 0, 0 }, std::move(summary));
+
+    for (size_t first = 0; first < counterparties.size(); first += COUNTERPARTY_PAGE) {
+        size_t count = std::min(COUNTERPARTY_PAGE, counterparties.size() - first);
+        std::string page;
+        for (uint32_t id = static_cast<uint32_t>(first); id < first + count; id++) {
+            putString(page, counterparties.nameOf(id));
+            putString(page, counterparties.balanceOf(id).toString());
+        }
+        writer.add(BlockInfo{ BLOCK_COUNTERPARTIES, 0, 0, 0, first, count, 0, 0 }, std::move(page));
+    }
+
+    // Activity is kept here because the ledger that saw it may sit in a segment file
+    std::string activity;
+    activity.reserve(counterparties.size() * sizeof(int64_t));
+    for (uint32_t id = 0; id < counterparties.size(); id++) {
+        putInt<int64_t>(activity, counterparties.lastActivityOf(id));
+    }
+    writer.add(BlockInfo{ BLOCK_ACTIVITY, 0, 0, 0, 0, counterparties.size(), 0, 0 }, std::move(activity));
+
+    std::string segmentList;
+    for (const LedgerSegment& segment : segments) {
+        putSegment(segmentList, segment);
+    }
+    writer.add(BlockInfo{ BLOCK_SEGMENTS, 0, 0, 0, 0, segments.size(), 0, 0 }, std::move(segmentList));
+
+    addLedgerBlocks(writer, ledger);
+    return writer.seal(crypto);
+}
+
+bool readSaveSummary(const BlockReader& reader, SaveSummary& out) {
+    size_t block = findBlock(reader.blocks(), BLOCK_SUMMARY);
+    std::string summary;
+    out = SaveSummary();
+    return block < reader.blocks().size() && reader.read(block, summary) && readSummary(summary, out);
+}
+
+bool blocksToData(const BlockReader& reader, std::map<std::string, std::string>& outDataMap, CounterpartyTable& outCounterparties, Ledger& outLedger, std::vector<LedgerSegment>* outSegments, uint64_t* outJournalSequence, LoadProgress* progress, LedgerSegment* outDeferred) {
+    SaveSummary summary;
+    if (!readSaveSummary(reader, summary)) return false;
+
+    const std::vector<BlockInfo>& blocks = reader.blocks();
+    std::vector<size_t> pages;
+    if (!collectRun(blocks, BLOCK_COUNTERPARTIES, summary.counterpartyCount, pages)) return false;
+
+    std::vector<BlockReader::Target> targets;
+    std::vector<std::string> pageData(pages.size());
+    for (size_t k = 0; k < pages.size(); k++) {
+        pageData[k].resize(static_cast<size_t>(blocks[pages[k]].size));
+        targets.push_back({ pages[k], &pageData[k][0] });
+    }
+    std::string activity, segmentList;
+    size_t activityBlock = findBlock(blocks, BLOCK_ACTIVITY);
+    if (activityBlock < blocks.size()) {
+        if (blocks[activityBlock].size != summary.counterpartyCount * sizeof(int64_t)) return false;
+        activity.resize(static_cast<size_t>(blocks[activityBlock].size));
+        targets.push_back({ activityBlock, &activity[0] });
+    }
+    size_t segmentsBlock = findBlock(blocks, BLOCK_SEGMENTS);
+    if (segmentsBlock < blocks.size()) {
+        segmentList.resize(static_cast<size_t>(blocks[segmentsBlock].size));
+        targets.push_back({ segmentsBlock, &segmentList[0] });
+    }
+
+    // Saves without an activity block recover last activity from the ledger, so they read it now
+    if (outDeferred) *outDeferred = LedgerSegment();
+    if (outDeferred && activityBlock < blocks.size() && summary.ledgerEntries > 0) {
+        std::vector<size_t> ledgerBlocks;
+        if (!collectRun(blocks, BLOCK_LEDGER, summary.ledgerEntries, ledgerBlocks)) return false;
+        outDeferred->entryCount = summary.ledgerEntries;
+        outDeferred->minTime = blocks[ledgerBlocks.front()].minTime;
+        outDeferred->maxTime = blocks[ledgerBlocks.front()].maxTime;
+        for (size_t i : ledgerBlocks) {
+            outDeferred->minTime = std::min(outDeferred->minTime, blocks[i].minTime);
+            outDeferred->maxTime = std::max(outDeferred->maxTime, blocks[i].maxTime);
+        }
+        outDeferred->openingBalance = summary.openingBalance;
+        outDeferred->closingBalance = summary.balance;
+        if (!reader.readInto(targets, 0, progress ? &progress->bytesDecrypted : nullptr,
+                             progress ? &progress->cancelled : nullptr)) return false;
+        outLedger.reset(summary.balance);
+    } else if (!readLedgerBlocks(reader, summary.ledgerEntries, summary.openingBalance, summary.balance, outLedger, std::move(targets), progress)) {
+        return false;
+    }
+
+    outCounterparties.clear();
+    outCounterparties.reserve(static_cast<size_t>(summary.counterpartyCount));
+    for (size_t k = 0; k < pages.size(); k++) {
+        Reader page{ pageData[k].data(), pageData[k].data() + pageData[k].size() };
+        for (uint64_t j = 0; j < blocks[pages[k]].count; j++) {
+            std::string_view name, balance;
+            if (!page.getString(name) || !page.getString(balance)) return false;
+            uint32_t id = outCounterparties.findOrAdd(name);
+            if (id + 1 != outCounterparties.size()) return false; // Duplicate name
+            outCounterparties.setBalance(id, Amount(std::string(balance)));
+        }
+        std::string().swap(pageData[k]);
+        if (progress) {
+            progress->recordsParsed += blocks[pages[k]].count;
+            if (progress->cancelled) return false;
+        }
+    }
+    for (uint32_t id = 0; id < activity.size() / sizeof(int64_t); id++) {
+        int64_t timestamp;
+        std::memcpy(&timestamp, activity.data() + id * sizeof(int64_t), sizeof(timestamp));
+        outCounterparties.touch(id, timestamp);
+    }
+
+    if (outSegments) {
+        outSegments->clear();
+        if (segmentsBlock < blocks.size()) {
+            Reader list{ segmentList.data(), segmentList.data() + segmentList.size() };
+            const size_t minSegmentBytes = 36; // Fixed fields plus two empty strings
+            if (blocks[segmentsBlock].count > segmentList.size() / minSegmentBytes) return false;
+            outSegments->resize(static_cast<size_t>(blocks[segmentsBlock].count));
+            for (LedgerSegment& segment : *outSegments) {
+                if (!readSegment(list, segment)) return false;
+            }
+        }
+    }
+
+    if (progress) progress->recordsParsed += outLedger.size();
+    outDataMap = std::move(summary.dataMap);
+    if (outJournalSequence) *outJournalSequence = summary.journalSequence;
+    return true;
+}
+
+bool blocksToLedger(const BlockReader& reader, Ledger& outLedger, LoadProgress* progress) {
+    SaveSummary summary;
+    return readSaveSummary(reader, summary) &&
+           readLedgerBlocks(reader, summary.ledgerEntries, summary.openingBalance, summary.balance, outLedger, {}, progress);
+}
+
+std::string segmentToBlocks(const LedgerSegment& segment, const Ledger& ledger, const std::vector<Amount>& closingBalances, const CryptoSession& crypto) {
+    BlockWriter writer;
+    std::string checkpoint;
+    putSegment(checkpoint, segment);
+    putInt<uint64_t>(checkpoint, closingBalances.size());
+    for (const Amount& balance : closingBalances) {
+        putString(checkpoint, balance.toString());
+    }
+    writer.add(BlockInfo{ BLOCK_CHECKPOINT, 0, 0, 0, 0, 1, segment.minTime, segment.maxTime }, std::move(checkpoint));
+    addLedgerBlocks(writer, ledger);
+    return writer.seal(crypto);
+}
+
+bool blocksToSegment(const BlockReader& reader, LedgerSegment& outSegment, Ledger& outLedger, std::vector<Amount>* outClosingBalances) {
+    size_t block = findBlock(reader.blocks(), BLOCK_CHECKPOINT);
+    std::string checkpoint;
+    if (block == reader.blocks().size() || !reader.read(block, checkpoint)) return false;
+
+    Reader cursor{ checkpoint.data(), checkpoint.data() + checkpoint.size() };
+    uint64_t count;
+    if (!readSegment(cursor, outSegment) || !cursor.getInt(count)) return false;
+    if (outClosingBalances) {
+        outClosingBalances->clear();
+        for (uint64_t i = 0; i < count; i++) {
+            std::string_view balance;
+            if (!cursor.getString(balance)) return false;
+            outClosingBalances->push_back(Amount(std::string(balance)));
+        }
+    }
+    return readLedgerBlocks(reader, outSegment.entryCount, outSegment.openingBalance, outSegment.closingBalance, outLedger, {}, nullptr);
+}
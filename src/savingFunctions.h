@@ -1,9 +1,75 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <map>
+#include <vector>
+
+#include "counterparties.h"
+#include "ledger.h"
+
+class BlockReader;
+class CryptoSession;
+
+// Counters a loader bumps as it goes, for a progress display on another thread.
+// Setting cancelled makes the loader stop early and fail.
+struct LoadProgress {
+    std::atomic<uint64_t> bytesTotal{ 0 };
+    std::atomic<uint64_t> bytesDecrypted{ 0 };
+    std::atomic<uint64_t> recordsParsed{ 0 };  // Counterparties, ledger entries and journal records
+    std::atomic<bool> cancelled{ false };
+};
 
 std::string loadFile(const std::string& filename, bool& err);
+// Existence check by stat, without reading the file
+bool fileOnDisk(const std::string& filename);
 bool saveToFile(const std::string& dataString, const std::string& filename);
 
-std::string dataToString(const std::map<std::string, std::string>& dataMap, const std::map<std::string, std::string>& borrowersMap, const std::vector<std::string>& orderVector);
-void stringToData(const std::string_view data, std::map<std::string, std::string>& outDataMap, std::map<std::string, std::string>& outBorrowersMap, std::vector<std::string>& outOrderVector);
+// Legacy text format: "key:value,...|name:balance,...|order,..."; the order list
+// starts with the dataMap keys, then counterparty names in id order
+std::string dataToString(const std::map<std::string, std::string>& dataMap, const CounterpartyTable& counterparties);
+void stringToData(const std::string_view data, std::map<std::string, std::string>& outDataMap, CounterpartyTable& outCounterparties);
+
+// Versioned binary save format (header + length-prefixed sections)
+// journalSequence is the last journal record already folded into this snapshot
+std::string dataToBinary(const std::map<std::string, std::string>& dataMap, const CounterpartyTable& counterparties, const Ledger& ledger, uint64_t journalSequence = 0);
+bool binaryToData(const std::string_view data, std::map<std::string, std::string>& outDataMap, CounterpartyTable& outCounterparties, Ledger& outLedger, uint64_t* outJournalSequence = nullptr, LoadProgress* progress = nullptr);
+bool isBinarySave(const std::string_view data);
+
+// Decode a decrypted save in either the binary or the legacy text format.
+// Returns false on a malformed save or when progress->cancelled is set.
+bool loadSaveData(const std::string_view data, std::map<std::string, std::string>& outDataMap, CounterpartyTable& outCounterparties, Ledger& outLedger, uint64_t* outJournalSequence = nullptr, LoadProgress* progress = nullptr);
+
+// Block save (see blockContainer.h): a summary block, counterparty pages, ledger
+// entry blocks and the ledger text pool, each encrypted and checksummed on its own.
+// segments lists the closed years kept in segment files, oldest first.
+std::string dataToBlocks(const std::map<std::string, std::string>& dataMap, const CounterpartyTable& counterparties, const Ledger& ledger, const std::vector<LedgerSegment>& segments, uint64_t journalSequence, const CryptoSession& crypto);
+// outDeferred, when given, leaves the ledger blocks encrypted: outLedger starts
+// empty from the saved balance and outDeferred describes the entries left for
+// blocksToLedger (year unused; entryCount 0 when they were read after all)
+bool blocksToData(const BlockReader& reader, std::map<std::string, std::string>& outDataMap, CounterpartyTable& outCounterparties, Ledger& outLedger, std::vector<LedgerSegment>* outSegments = nullptr, uint64_t* outJournalSequence = nullptr, LoadProgress* progress = nullptr, LedgerSegment* outDeferred = nullptr);
+// Decrypt only the ledger of a block save
+bool blocksToLedger(const BlockReader& reader, Ledger& outLedger, LoadProgress* progress = nullptr);
+
+// Segment file for one closed year: a checkpoint (the segment and every
+// counterparty balance at its end, by id) plus the year's ledger
+std::string segmentToBlocks(const LedgerSegment& segment, const Ledger& ledger, const std::vector<Amount>& closingBalances, const CryptoSession& crypto);
+bool blocksToSegment(const BlockReader& reader, LedgerSegment& outSegment, Ledger& outLedger, std::vector<Amount>* outClosingBalances = nullptr);
+
+// What the dashboard shows, as of when the snapshot was written (journal
+// changes since then are not included)
+struct SaveSummary {
+    std::map<std::string, std::string> dataMap;
+    uint64_t journalSequence = 0;
+    uint64_t counterpartyCount = 0;
+    uint64_t ledgerEntries = 0;
+    Amount openingBalance;
+    Amount balance;
+    CounterpartyTotals totals;
+    std::string largestName;  // Empty when every balance is zero
+    Amount largestBalance;
+};
+
+// Decrypt only the summary block of a block save
+bool readSaveSummary(const BlockReader& reader, SaveSummary& out);
@@ -0,0 +1,84 @@
+// embedIcon - build-time converter from resources/app_icon.png to a header of
+// pre-decoded RGBA images, so the GUI sets its window icon without touching disk.
+// Usage: embedIcon <input.png> <output.h>
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <cstdio>
+#include <vector>
+
+// Window managers pick the closest size; larger ones only cost binary size
+static const int ICON_SIZES[] = { 16, 32, 48, 64 };
+
+// Area-average downscale with alpha-weighted colour, so transparent pixels do not darken the edges
+static std::vector<unsigned char> downscale(const unsigned char* src, int srcWidth, int srcHeight, int size) {
+    std::vector<unsigned char> out(static_cast<size_t>(size) * size * 4);
+    for (int y = 0; y < size; y++) {
+        int y0 = y * srcHeight / size, y1 = (y + 1) * srcHeight / size;
+        for (int x = 0; x < size; x++) {
+            int x0 = x * srcWidth / size, x1 = (x + 1) * srcWidth / size;
+            double r = 0, g = 0, b = 0, a = 0;
+            for (int sy = y0; sy < y1; sy++) {
+                for (int sx = x0; sx < x1; sx++) {
+                    const unsigned char* p = src + (static_cast<size_t>(sy) * srcWidth + sx) * 4;
+                    r += p[0] * p[3];
+                    g += p[1] * p[3];
+                    b += p[2] * p[3];
+                    a += p[3];
+                }
+            }
+            unsigned char* q = &out[(static_cast<size_t>(y) * size + x) * 4];
+            int count = (y1 - y0) * (x1 - x0);
+            if (count == 0 || a == 0) {
+                q[0] = q[1] = q[2] = q[3] = 0;
+                continue;
+            }
+            q[0] = static_cast<unsigned char>(r / a + 0.5);
+            q[1] = static_cast<unsigned char>(g / a + 0.5);
+            q[2] = static_cast<unsigned char>(b / a + 0.5);
+            q[3] = static_cast<unsigned char>(a / count + 0.5);
+        }
+    }
+    return out;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "Usage: %s <input.png> <output.h>\n", argv[0]);
+        return 1;
+    }
+
+    int width = 0, height = 0;
+    unsigned char* pixels = stbi_load(argv[1], &width, &height, nullptr, 4); // 4 = RGBA
+    if (pixels == nullptr) {
+        std::fprintf(stderr, "embedIcon: cannot decode %s\n", argv[1]);
+        return 1;
+    }
+
+    FILE* out = std::fopen(argv[2], "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "embedIcon: cannot write %s\n", argv[2]);
+        stbi_image_free(pixels);
+        return 1;
+    }
+
+    std::fprintf(out, "// Generated by tools/embedIcon.cpp - do not edit\n#pragma once\n\n");
+    std::fprintf(out, "struct EmbeddedIcon {\n    int width;\n    int height;\n    const unsigned char* pixels; // RGBA\n};\n\n");
+    for (int size : ICON_SIZES) {
+        std::vector<unsigned char> image = downscale(pixels, width, height, size);
+        std::fprintf(out, "static const unsigned char APP_ICON_%d[] = {", size);
+        for (size_t i = 0; i < image.size(); i++) {
+            std::fprintf(out, "%s%u,", i % 24 == 0 ? "\n    " : "", image[i]);
+        }
+        std::fprintf(out, "\n};\n\n");
+    }
+    std::fprintf(out, "static const EmbeddedIcon APP_ICONS[] = {\n");
+    for (int size : ICON_SIZES) {
+        std::fprintf(out, "    { %d, %d, APP_ICON_%d },\n", size, size, size);
+    }
+    std::fprintf(out, "};\n");
+
+    stbi_image_free(pixels);
+    bool ok = std::fclose(out) == 0;
+    return ok ? 0 : 1;
+}